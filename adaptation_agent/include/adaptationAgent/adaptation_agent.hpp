@@ -19,8 +19,14 @@
 #ifndef ADAPTATIONAGENT__ADAPTATION_AGENT_HPP_
 #define ADAPTATIONAGENT__ADAPTATION_AGENT_HPP_
 
+#include <chrono>
+#include <map>
+#include <optional>
 #include <mutex>
+#include <set>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 
 // Qt
 #include <QObject>
@@ -37,8 +43,13 @@
 #include "dsr/api/dsr_api.h"
 #include "dsr/gui/dsr_gui.h"
 
+#include "adaptationAgent/decision_engine.hpp"
+#include "adaptationAgent/decision_trace.hpp"
+#include "adaptationAgent/minute_clock.hpp"
+#include "adaptationAgent/person_store.hpp"
+#include "adaptationAgent/use_case_scheduler.hpp"
 #include "adaptationAgent/types.hpp"
-#include "adaptationAgent/preference_learning.hpp"
+#include "../../../include/async_logger.hpp"
 
 
 class AdaptationAgent : public QObject
@@ -64,19 +75,43 @@ public:
    * @brief Initialize the logger.
    *
    * @param log_filepath The path to the log file.
+   * @param params The parameters of the loggers.
    */
-  void initializeLogger(std::string log_filepath);
+  void initializeLogger(
+    std::string log_filepath, const loggerParameters & params = loggerParameters());
+
+  /**
+   * @brief Set the clock used to check the agendas. By default, the local time of the system.
+   *
+   * @param clock The new clock.
+   */
+  void setClock(std::unique_ptr<MinuteClock> clock);
+
+  /**
+   * @brief Set the limits to the changes of use case. It must be called before
+   * initializing the preference learning.
+   *
+   * @param policy The battery thresholds, minimum dwell time and debounce window.
+   */
+  void setSwitchingPolicy(const switchingPolicy & policy);
 
   /**
    * @brief Initialize the preference learning.
    *
    * @param models The path to the models.
+   * @param shadow_models The path to the candidate models evaluated in the background.
+   * Empty to disable the shadow evaluation.
+   * @param safety_period The period in milliseconds of the compute that runs even if
+   * no input has changed.
    */
-  void initializeAdaptation(std::string models);
+  void initializeAdaptation(
+    std::string models, std::string shadow_models = "", int safety_period = 5000);
 
 public slots:
   /**
    * @brief Launch the adaptation agent.
+   * It runs when any of the inputs of the decision changes, when an activity of the agenda
+   * starts or ends and periodically as a backstop.
    */
   void compute();
 
@@ -93,91 +128,120 @@ public slots:
 
 private:
   /**
-   * @brief Abort the current use case in the DSR.
-   * - Change all 'wants_to' edges connecting action nodes to 'cancel'
-   * - Change all 'is_performing' edges connecting action nodes to 'abort'
+   * @brief Inputs of the decision that trigger a new compute when they change.
    */
-  void abortCurrentUseCaseInDsr();
+  enum DirtyInput : uint32_t
+  {
+    BATTERY = 1 << 0,
+    AGENDA = 1 << 1,
+    BUTTONS = 1 << 2,
+    PEOPLE = 1 << 3,
+    USE_CASE = 1 << 4
+  };
 
   /**
-   * @brief Set the new use case in the DSR.
+   * @brief Mark an input as changed and schedule a compute in the next event loop iteration.
+   * Several changes in the same iteration only trigger one compute.
    *
-   * @param new_use_case The new use case.
-   * @return bool If the new use case was set.
+   * @param input The input that has changed.
    */
-  bool setNewUseCaseInDsr(const std::string & new_use_case);
+  void markDirty(DirtyInput input);
 
   /**
-   * @brief Set the new use case with priority.
+   * @brief Start the timer that triggers a compute when the next activity of the robot or
+   * the people agenda starts or ends.
+   */
+  void armAgendaTimer();
+
+  /**
+   * @brief Check if the node is one of the request nodes created by the buttons.
    *
-   * @param use_case The new use case.
-   * @return bool If the new use case was set.
+   * @param node_name The name of the node.
+   * @return bool True if the node is 'bring_water', 'tracking' or 'explanation'.
    */
-  bool priorityUseCase(UseCase & use_case);
+  bool isButtonNode(const std::string & node_name);
 
   /**
-   * @brief Set the new use case for a group.
+   * @brief Update the presence of a request node created by the buttons.
    *
-   * @param use_case The new use case.
-   * @return bool If the new use case was set.
+   * @param node_name The name of the node.
+   * @param present True if the node is in the graph.
    */
-  bool plannedGroupUseCase(UseCase & use_case);
+  void setButtonPresent(const std::string & node_name, bool present);
 
   /**
-   * @brief Set the new use case if a button is pushed.
+   * @brief Apply a decision of the engine to the DSR. It runs in the Qt thread.
    *
-   * @param use_case The new use case.
-   * @return bool If the new use case was set.
+   * @param result The decision taken by the engine.
    */
-  bool buttonPushedUseCase(UseCase & use_case);
+  void applyDecision(const decisionResult & result);
 
   /**
-   * @brief Set the new use case if a person is detected.
+   * @brief Abort the current use case in the DSR.
+   * - Change the 'wants_to' edges of the use case connecting action nodes to 'cancel'
+   * - Change the 'is_performing' edges of the use case connecting action nodes to 'abort'
+   */
+  void abortCurrentUseCaseInDsr();
+
+  /**
+   * @brief Check if an edge requests an action that is aborted with the use case.
    *
-   * @param use_case The new use case.
-   * @return bool If the new use case was set.
+   * @param edge_type The type of the edge.
+   * @param to_node The destination node of the edge.
+   * @return bool True if it is a 'wants_to' or 'is_performing' edge to an action node.
+   */
+  bool isActionEdge(const std::string & edge_type, const DSR::Node & to_node);
+
+  /**
+   * @brief Add the edge to the index of action edges if it requests an action while
+   * a use case is active.
+   *
+   * @param from The origin node of the edge.
+   * @param to The destination node of the edge.
+   * @param type The type of the edge.
    */
-  UseCase selectedUseCaseForUser(int user);
+  void trackActionEdge(std::uint64_t from, std::uint64_t to, const std::string & type);
 
   /**
-   * @brief Evaluate the use case.
+   * @brief Set the new use case in the DSR.
    *
-   * @param use_case The use case.
-   * @return int The evaluation of the use case.
+   * @param new_use_case The new use case.
+   * @return bool If the new use case was set.
    */
-  int evaluate(UseCase use_case);
+  bool setNewUseCaseInDsr(const std::string & new_use_case);
 
   /**
-   * @brief Find the activity in the agenda.
+   * @brief Update the data of a person with all the attributes of its node.
    *
-   * @param activity_name The name of the activity.
-   * @param pretime The previous time.
-   * @return bool If the activity was found.
+   * @param person The person to update.
+   * @param node The DSR node of the person.
    */
-  bool findActivityInAgenda(std::string activity_name, int pretime);
+  void updatePersonFromNode(personData & person, const DSR::Node & node);
 
   /**
-   * @brief Check if a person is busy.
+   * @brief Update only the data of a person that comes from the changed attributes.
    *
-   * @param person The person data.
-   * @param pretime The previous time.
-   * @return bool If the person is busy.
+   * @param person The person to update.
+   * @param node The DSR node of the person.
+   * @param att_names The names of the changed attributes.
+   * @return bool True if any data of the person has changed.
    */
-  bool isPersonBusy(personData person, int pretime = 10);
+  bool updatePersonFromNode(
+    personData & person, const DSR::Node & node, const std::vector<std::string> & att_names);
 
   /**
-   * @brief Update the input data for the user.
+   * @brief Update one field of a person with the attribute of its node.
    *
-   * @param user_id The ID of the user.
-   * @return std::vector<int64_t> The updated input data.
+   * @param person The person to update.
+   * @param node The DSR node of the person.
+   * @param field The field to update.
    */
-  std::vector<int64_t> updateInputDataUser(int user_id);
+  void updatePersonField(personData & person, const DSR::Node & node, PersonField field);
 
   // Helpers
   int StringTimeToMinutes(std::string hour);
+  std::vector<agendaActivity> parseAgenda(const std::string & agenda);
   UseCase fromStr(std::string use_case_str);
-  std::string toStr(UseCase use_case);
-  std::string currentTime(int premin);
   bool notWaitUseCase(UseCase prior);
 
   // DSR graph
@@ -187,15 +251,38 @@ private:
 
   // Log related variables
   std::string log_filepath_;
-  std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> console_sink_;
-  std::shared_ptr<spdlog::sinks::basic_file_sink_mt> debug_file_sink_;
-  std::unique_ptr<spdlog::logger> logger_;
-  std::shared_ptr<spdlog::sinks::basic_file_sink_mt> explicability_file_sink_;
-  std::unique_ptr<spdlog::logger> expl_logger_;
-
+  std::string log_folder_;
+  // Parameters of the loggers, also used by the logger of the candidate models
+  loggerParameters logger_params_;
+  spdlog::sink_ptr console_sink_;
+  spdlog::sink_ptr debug_file_sink_;
+  std::shared_ptr<spdlog::logger> logger_;
+  spdlog::sink_ptr explicability_file_sink_;
+  std::shared_ptr<spdlog::logger> expl_logger_;
+  std::shared_ptr<spdlog::logger> shadow_logger_;
+
+  // Safety tick, next agenda boundary and pending compute timers
   QTimer timer_;
+  QTimer agenda_timer_;
+  QTimer compute_trigger_;
+  // The inputs are published at most once per interval, so a decision ends before the
+  // next inputs are published even when they change continuously
+  static constexpr std::chrono::milliseconds kMinComputeInterval{200};
+  std::chrono::steady_clock::time_point last_compute_;
+  // Triggers a compute when a delayed switch of use case is allowed
+  QTimer switch_timer_;
+  uint32_t dirty_inputs_;
+  std::unique_ptr<MinuteClock> clock_;
+
+  // Node of the use case being performed, if any
+  std::optional<uint64_t> use_case_id_;
+  // The 'wants_to' and 'is_performing' edges to action nodes created while the current use
+  // case is active, by origin, destination and type
+  std::set<std::tuple<uint64_t, uint64_t, std::string>> action_edges_;
 
   // Use case flow control variables
+  switchingPolicy switching_policy_;
+  UseCaseScheduler scheduler_;
   UseCase selected_use_case_;
   UseCase previous_use_case_;
   UseCase current_use_case_;
@@ -211,16 +298,39 @@ private:
     {"music", 5}
   };
   std::vector<int64_t> enviroment_data_;
-  std::unique_ptr<PreferenceLearning> pref_learning_;
+  // Last decisions of the engine, dumped to the explicability log on request
+  DecisionTrace decision_trace_;
+  std::unique_ptr<DecisionEngine> decision_engine_;
+  // Sequence of the last inputs published to the engine
+  uint64_t published_sequence_;
 
   // Current interacting person
   personData interacting_person_;
   // Current person using the robot
   personData current_person_use_case_;
   // Current people with the robot
-  std::vector<personData> people_with_robot_;
+  PersonStore people_with_robot_;
+  // Attributes of the person nodes used by the agent and the field they update
+  static inline const std::unordered_map<std::string, PersonField> kPersonAttributes = {
+    {"comm_parameters", PersonField::COMM_PARAMETERS},
+    {"skills_parameters", PersonField::PROFILE},
+    {"activities", PersonField::ACTIVITIES},
+    {"menu1", PersonField::MENU},
+    {"neuron", PersonField::NEURON},
+    {"reminder", PersonField::REMINDER}
+  };
   // Current robot agenda
   std::string robot_agenda_;
+  std::vector<agendaActivity> robot_activities_;
+  // Incremented each time the robot agenda changes
+  uint64_t robot_agenda_version_;
+  // Last battery level read from the graph
+  static constexpr float kDefaultBatteryLevel = 50.0;
+  float battery_level_;
+  // Request nodes created by the buttons currently in the graph
+  bool bring_water_present_;
+  bool tracking_present_;
+  bool explanation_present_;
 };
 
 #endif  // ADAPTATIONAGENT__ADAPTATION_AGENT_HPP_
@@ -0,0 +1,236 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ADAPTATIONAGENT__DECISION_ENGINE_HPP_
+#define ADAPTATIONAGENT__DECISION_ENGINE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// SPDLOG
+#include "spdlog/spdlog.h"
+
+#include "adaptationAgent/decision_trace.hpp"
+#include "adaptationAgent/preference_learning.hpp"
+#include "adaptationAgent/types.hpp"
+#include "../../../include/latency_histogram.hpp"
+
+// Inputs of a decision. They are copied from the agent and never modified after published
+struct decisionInputs
+{
+  uint64_t sequence;
+  // Minute of the day of the decision
+  int minute;
+  float battery_level;
+  bool bring_water_present;
+  bool tracking_present;
+  bool explanation_present;
+  std::vector<agendaActivity> robot_activities;
+  uint64_t robot_agenda_version;
+  bool person_interacting;
+  std::vector<personData> people;
+};
+
+// Use case selected with some inputs
+struct decisionResult
+{
+  uint64_t sequence;
+  // Empty if the current selection must be kept
+  std::optional<UseCase> use_case;
+  // Identifier of the person selected, if any
+  std::string person;
+  // Rule that selected the use case
+  DecisionRule rule;
+};
+
+/**
+ * @brief Class that selects the use case in a dedicated thread.
+ * The agent publishes the inputs with a pointer swap and only the latest ones are evaluated,
+ * so the Qt thread that delivers the DSR signals never waits for the models.
+ */
+class DecisionEngine
+{
+public:
+  // Minutes in advance to check if a person is busy
+  static constexpr int kBusyPretime = 15;
+
+  /**
+   * @brief Construct a new Decision Engine object and start the thread.
+   *
+   * @param pref_learning The preference learning models.
+   * @param battery_low Battery level to start charging.
+   * @param battery_recovered Battery level to stop charging.
+   * @param trace The trace where the decisions are recorded.
+   * @param logger The logger of the agent.
+   * @param on_decision Function called from the thread with each decision.
+   */
+  DecisionEngine(
+    std::unique_ptr<PreferenceLearning> pref_learning, float battery_low,
+    float battery_recovered, DecisionTrace * trace, spdlog::logger * logger,
+    std::function<void(const decisionResult &)> on_decision);
+
+  /**
+   * @brief Destroy the Decision Engine object. Stop the thread.
+   */
+  ~DecisionEngine();
+
+  /**
+   * @brief Publish new inputs. If the previous ones have not been evaluated yet,
+   * they are replaced. It only waits for the pointer swap.
+   *
+   * @param inputs The inputs of the decision.
+   */
+  void publish(std::shared_ptr<const decisionInputs> inputs);
+
+private:
+  /**
+   * @brief Main loop of the thread.
+   */
+  void run();
+
+  /**
+   * @brief Select the use case for the inputs.
+   *
+   * @param inputs The inputs of the decision.
+   * @param record The record of the decision for the trace.
+   * @return decisionResult The use case selected.
+   */
+  decisionResult decide(const decisionInputs & inputs, decisionRecord & record);
+
+  /**
+   * @brief Set the new use case with priority.
+   * Charging starts below the low battery level and ends above the recovered one.
+   *
+   * @param inputs The inputs of the decision.
+   * @param use_case The new use case.
+   * @return bool If the new use case was set.
+   */
+  bool priorityUseCase(const decisionInputs & inputs, UseCase & use_case);
+
+  /**
+   * @brief Set the new use case for a group.
+   *
+   * @param inputs The inputs of the decision.
+   * @param use_case The new use case.
+   * @return bool If the new use case was set.
+   */
+  bool plannedGroupUseCase(const decisionInputs & inputs, UseCase & use_case);
+
+  /**
+   * @brief Set the new use case if a button is pushed.
+   *
+   * @param inputs The inputs of the decision.
+   * @param use_case The new use case.
+   * @return bool If the new use case was set.
+   */
+  bool buttonPushedUseCase(const decisionInputs & inputs, UseCase & use_case);
+
+  /**
+   * @brief Set the new use case if a person is detected.
+   *
+   * @param user_inputs The inputs of the models for the person.
+   * @return UseCase The use case selected for the person.
+   */
+  UseCase selectedUseCaseForUser(const std::vector<int64_t> & user_inputs);
+
+  /**
+   * @brief Get the use case selected for a user and its score.
+   * They are only computed again if the person, the robot agenda or the minute of the day
+   * have changed since the last call.
+   *
+   * @param inputs The inputs of the decision.
+   * @param person The person with the robot.
+   * @return const userDecision& The use case and its score.
+   */
+  const userDecision & decisionForUser(const decisionInputs & inputs, const personData & person);
+
+  /**
+   * @brief Evaluate the use case.
+   *
+   * @param use_case The use case.
+   * @return int The evaluation of the use case.
+   */
+  int evaluate(UseCase use_case);
+
+  /**
+   * @brief Find the activity in the agenda.
+   *
+   * @param inputs The inputs of the decision.
+   * @param activity_name The name of the activity.
+   * @param pretime The previous time.
+   * @return bool If the activity was found.
+   */
+  bool findActivityInAgenda(
+    const decisionInputs & inputs, const std::string & activity_name, int pretime);
+
+  /**
+   * @brief Check if a person is busy.
+   *
+   * @param inputs The inputs of the decision.
+   * @param person The person data.
+   * @param pretime The previous time.
+   * @return bool If the person is busy.
+   */
+  bool isPersonBusy(const decisionInputs & inputs, const personData & person, int pretime);
+
+  /**
+   * @brief Update the input data for the user.
+   *
+   * @param inputs The inputs of the decision.
+   * @param person The person with the robot.
+   * @return std::vector<int64_t> The updated input data.
+   */
+  std::vector<int64_t> updateInputDataUser(
+    const decisionInputs & inputs, const personData & person);
+
+  /**
+   * @brief Log the latency of the decisions and the models and start a new period.
+   */
+  void reportLatencies();
+
+  std::unique_ptr<PreferenceLearning> pref_learning_;
+  float battery_low_;
+  float battery_recovered_;
+  // The robot keeps charging until the battery has recovered. Only used by the thread
+  bool charging_;
+  DecisionTrace * trace_;
+  spdlog::logger * logger_;
+  std::function<void(const decisionResult &)> on_decision_;
+
+  // Latest inputs published and not evaluated yet. The mutex is only held to swap them
+  std::mutex inputs_mutex_;
+  std::shared_ptr<const decisionInputs> inputs_;
+  std::atomic<bool> pending_;
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  // Last decision of each person, by identifier. Only used by the thread
+  std::unordered_map<std::string, userDecision> decisions_;
+
+  // Latency of the whole decision, logged every kLatencyReportPeriod decisions
+  static constexpr uint64_t kLatencyReportPeriod = 600;
+  LatencyHistogram decision_latency_;
+};
+
+#endif  // ADAPTATIONAGENT__DECISION_ENGINE_HPP_
@@ -0,0 +1,151 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ADAPTATIONAGENT__DECISION_TRACE_HPP_
+#define ADAPTATIONAGENT__DECISION_TRACE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <semaphore.h>
+
+// SPDLOG
+#include "spdlog/spdlog.h"
+
+// Maximum number of users stored in a record
+constexpr std::size_t kMaxTraceUsers = 8;
+
+// Rule of the decision that selected the use case
+enum class DecisionRule : uint8_t { PRIORITY, GROUP, BUTTON, USER, INTERACTING };
+
+// Use case voted for a user and the inputs of the models
+struct traceUser
+{
+  char identifier[24];
+  int8_t inputs[4];
+  uint8_t use_case;
+  int8_t score;
+};
+
+// Compact record of a decision. It is copied as is into the trace
+struct decisionRecord
+{
+  int64_t timestamp;
+  uint64_t sequence;
+  int64_t latency;
+  float battery_level;
+  int16_t minute;
+  DecisionRule rule;
+  uint8_t use_case;
+  // Number of users with the robot. Only the first kMaxTraceUsers are stored
+  uint8_t num_users;
+  traceUser users[kMaxTraceUsers];
+};
+
+/**
+ * @brief Fixed-size ring of the last decisions.
+ * One thread writes the records without locks or formatting and they are decoded to a log
+ * by a background thread only when a dump is requested, for example with SIGUSR1.
+ * When the ring is full, the oldest records are overwritten.
+ */
+class DecisionTrace
+{
+public:
+  static constexpr std::size_t kCapacity = 256;
+
+  DecisionTrace();
+
+  /**
+   * @brief Destroy the Decision Trace object. Stop the dumper thread.
+   */
+  ~DecisionTrace();
+
+  /**
+   * @brief Add a record to the trace. Only one thread can write.
+   *
+   * @param record The record of the decision.
+   */
+  void write(const decisionRecord & record);
+
+  /**
+   * @brief Get the records written since the last read that have not been overwritten.
+   * Only one thread can read.
+   *
+   * @return std::vector<decisionRecord> The records from the oldest to the newest.
+   */
+  std::vector<decisionRecord> read();
+
+  /**
+   * @brief Start the thread that dumps the trace when it is requested.
+   *
+   * @param logger The logger where the records are dumped.
+   */
+  void startDumper(spdlog::logger * logger);
+
+  /**
+   * @brief Request a dump of the trace. It is safe to call from a signal handler.
+   */
+  static void requestDump();
+
+  /**
+   * @brief Decode a record to a readable line.
+   *
+   * @param record The record of the decision.
+   * @return std::string The decoded record.
+   */
+  static std::string decode(const decisionRecord & record);
+
+private:
+  static_assert(std::is_trivially_copyable_v<decisionRecord>);
+  // Words of a record in a slot
+  static constexpr std::size_t kRecordWords = (sizeof(decisionRecord) + 7) / 8;
+
+  /**
+   * @brief Slot of the ring. The sequence is odd while the record is being written.
+   * The record is stored in atomic words, so the reader can copy it while it is
+   * overwritten and then discard the torn copy.
+   */
+  struct Slot
+  {
+    std::atomic<uint64_t> sequence{0};
+    std::array<std::atomic<uint64_t>, kRecordWords> words{};
+  };
+
+  /**
+   * @brief Dump the records written since the last dump.
+   *
+   * @param logger The logger where the records are dumped.
+   */
+  void dump(spdlog::logger * logger);
+
+  std::array<Slot, kCapacity> slots_;
+  // Position of the next record to write
+  std::atomic<uint64_t> head_;
+  // Position of the next record to read. Only used by the reader
+  uint64_t next_read_;
+  static inline std::atomic<bool> dump_requested_{false};
+  // Posted by requestDump to wake the dumper, as sem_post is safe in a signal handler
+  static inline sem_t dump_semaphore_;
+  static inline std::atomic<bool> dumper_started_{false};
+  std::atomic<bool> running_;
+  std::thread dumper_;
+};
+
+#endif  // ADAPTATIONAGENT__DECISION_TRACE_HPP_
@@ -0,0 +1,129 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ADAPTATIONAGENT__MINUTE_CLOCK_HPP_
+#define ADAPTATIONAGENT__MINUTE_CLOCK_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief Clock that gives the time as minutes of the day, used to check the agendas.
+ */
+class MinuteClock
+{
+public:
+  static constexpr int kMinutesPerDay = 24 * 60;
+
+  virtual ~MinuteClock() = default;
+
+  /**
+   * @brief Get the current minute of the day.
+   *
+   * @param offset Minutes added to the current time.
+   * @return int The minute of the day in the range [0, 1440).
+   */
+  virtual int minuteOfDay(int offset = 0) const = 0;
+
+  /**
+   * @brief Get the real time until the given number of minute boundaries have passed.
+   *
+   * @param minutes The number of minute boundaries. 1 is the start of the next minute.
+   * @return std::chrono::milliseconds The real time to wait.
+   */
+  virtual std::chrono::milliseconds untilMinutes(int minutes) const = 0;
+
+protected:
+  static int wrap(int minute)
+  {
+    return (minute % kMinutesPerDay + kMinutesPerDay) % kMinutesPerDay;
+  }
+};
+
+/**
+ * @brief Clock with the local time of the system.
+ */
+class SystemMinuteClock : public MinuteClock
+{
+public:
+  int minuteOfDay(int offset = 0) const override
+  {
+    std::tm now_tm = localTime();
+    return wrap(now_tm.tm_hour * 60 + now_tm.tm_min + offset);
+  }
+
+  std::chrono::milliseconds untilMinutes(int minutes) const override
+  {
+    std::tm now_tm = localTime();
+    return std::chrono::milliseconds((minutes * 60 - now_tm.tm_sec) * 1000);
+  }
+
+private:
+  static std::tm localTime()
+  {
+    std::time_t current_time = std::time(nullptr);
+    std::tm now_tm;
+    localtime_r(&current_time, &now_tm);
+    return now_tm;
+  }
+};
+
+/**
+ * @brief Clock that starts at a given minute of the day and runs faster than the real time.
+ * It is used to run a whole day of agenda-driven decisions in a short time.
+ */
+class SimulatedMinuteClock : public MinuteClock
+{
+public:
+  /**
+   * @brief Construct a new Simulated Minute Clock object.
+   *
+   * @param start_minute The minute of the day when the clock starts.
+   * @param speed The number of simulated seconds per real second.
+   */
+  SimulatedMinuteClock(int start_minute, double speed)
+  : start_ms_(static_cast<int64_t>(wrap(start_minute)) * 60000),
+    speed_(speed > 0.0 ? speed : 1.0), start_(std::chrono::steady_clock::now())
+  {
+  }
+
+  int minuteOfDay(int offset = 0) const override
+  {
+    return wrap(static_cast<int>(simulatedMs() / 60000 % kMinutesPerDay) + offset);
+  }
+
+  std::chrono::milliseconds untilMinutes(int minutes) const override
+  {
+    int64_t now_ms = simulatedMs();
+    int64_t target_ms = (now_ms / 60000 + minutes) * 60000;
+    return std::chrono::milliseconds(
+      static_cast<int64_t>(static_cast<double>(target_ms - now_ms) / speed_) + 1);
+  }
+
+private:
+  int64_t simulatedMs() const
+  {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start_);
+    return start_ms_ + static_cast<int64_t>(static_cast<double>(elapsed.count()) * speed_);
+  }
+
+  int64_t start_ms_;
+  double speed_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+#endif  // ADAPTATIONAGENT__MINUTE_CLOCK_HPP_
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ADAPTATIONAGENT__PERSON_STORE_HPP_
+#define ADAPTATIONAGENT__PERSON_STORE_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "adaptationAgent/types.hpp"
+
+/**
+ * @brief People with the robot, keyed by the ID of their DSR node and indexed by identifier.
+ * The people are iterated in the order of their node ID.
+ */
+class PersonStore
+{
+public:
+  using iterator = std::map<uint64_t, personData>::iterator;
+  using const_iterator = std::map<uint64_t, personData>::const_iterator;
+
+  /**
+   * @brief Find a person by the ID of its node.
+   *
+   * @param node_id The ID of the DSR node.
+   * @return personData* The person or nullptr if it is not in the store.
+   */
+  personData * find(uint64_t node_id);
+
+  /**
+   * @brief Find a person by its identifier.
+   *
+   * @param identifier The identifier of the person.
+   * @return personData* The person or nullptr if it is not in the store.
+   */
+  personData * find(const std::string & identifier);
+
+  /**
+   * @brief Get the person of a node, adding it if it is not in the store.
+   * If the identifier was stored with another node, the person is moved to the new node.
+   *
+   * @param node_id The ID of the DSR node.
+   * @param identifier The identifier of the person.
+   * @return personData& The person.
+   */
+  personData & insert(uint64_t node_id, const std::string & identifier);
+
+  /**
+   * @brief Remove the person of a node.
+   *
+   * @param node_id The ID of the DSR node.
+   * @return bool True if the person was in the store.
+   */
+  bool erase(uint64_t node_id);
+
+  std::size_t size() const {return people_.size();}
+  bool empty() const {return people_.empty();}
+  iterator begin() {return people_.begin();}
+  iterator end() {return people_.end();}
+  const_iterator begin() const {return people_.begin();}
+  const_iterator end() const {return people_.end();}
+
+private:
+  std::map<uint64_t, personData> people_;
+  std::unordered_map<std::string, uint64_t> by_identifier_;
+};
+
+#endif  // ADAPTATIONAGENT__PERSON_STORE_HPP_
@@ -14,13 +14,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <onnxruntime/onnxruntime_cxx_api.h>
 
+// SPDLOG
+#include "spdlog/spdlog.h"
+
 #include "adaptationAgent/types.hpp"
+#include "../../../include/latency_histogram.hpp"
+
+class ShadowEvaluator;
 
 #ifndef ADAPTATIONCOMP__PREFERENCE_LEARNING_HPP_
 #define ADAPTATIONCOMP__PREFERENCE_LEARNING_HPP_
@@ -48,7 +56,7 @@ public:
    * @brief Destroy the Preference Learning object
    *
    */
-  ~PreferenceLearning() = default;
+  ~PreferenceLearning();
 
   /**
   * @brief Loads the sessions.
@@ -59,6 +67,15 @@ public:
   */
   void loadSessions(std::string folderpath);
 
+  /**
+   * @brief Loads a candidate set of models that is evaluated in the background with the
+   * same inputs as the live models. It doesn't change the result of getPriorities.
+   *
+   * @param folderpath The name of the folder where the candidate ONNX models are stored.
+   * @param logger The logger where the agreement statistics and divergent cases are written.
+   */
+  void loadShadowSessions(std::string folderpath, std::shared_ptr<spdlog::logger> logger);
+
   /**
    * @brief Given a vector of integer input_data, it returns a vector of UseCase
    * with the priorities of the use cases.
@@ -68,6 +85,62 @@ public:
    */
   std::vector<UseCase> getPriorities(std::vector<int64_t> input_data);
 
+  /**
+   * @brief Given a batch of input vectors, it returns the priorities of the use cases for
+   * each one of them. Each model is run only once for the whole batch.
+   *
+   * @param batch The input data in form of vectors of integer of the same size.
+   * @return std::vector<std::vector<UseCase>> The priorities of the use cases for each input.
+   */
+  std::vector<std::vector<UseCase>> getPrioritiesBatch(
+    const std::vector<std::vector<int64_t>> & batch);
+
+  /**
+   * @brief Get the names of the loaded ONNX models.
+   *
+   * @return const std::vector<std::string>& The names of the models.
+   */
+  const std::vector<std::string> & getModelNames() const {return model_names_;}
+
+  /**
+   * @brief Get the time spent loading the given model.
+   *
+   * @param model The index of the model in getModelNames.
+   * @return std::chrono::nanoseconds The time to create the session of the model.
+   */
+  std::chrono::nanoseconds getLoadTime(std::size_t model) const {return load_times_.at(model);}
+
+  /**
+   * @brief Get the histogram of the inference latency of the given model.
+   *
+   * @param model The index of the model in getModelNames.
+   * @return const LatencyHistogram& The latencies of the model.
+   */
+  const LatencyHistogram & getModelLatency(std::size_t model) const
+  {
+    return model_latencies_.at(model);
+  }
+
+  /**
+   * @brief Get the histogram of the latency of getPriorities, from the input to the priorities.
+   *
+   * @return const LatencyHistogram& The latencies of each decision.
+   */
+  const LatencyHistogram & getDecisionLatency() const {return decision_latency_;}
+
+  /**
+   * @brief Remove all the latencies recorded.
+   */
+  void resetLatencies();
+
+  /**
+   * @brief It returns the code used in the ONNX file names for a given use case.
+   *
+   * @param use_case The use case.
+   * @return std::string The code of the use case (DEAM, RECA, ...) or an empty string.
+   */
+  static std::string getStringFromUseCase(UseCase use_case);
+
 private:
   /**
    * @brief Loads all the ONNX models files from the folderpath class variable and stores
@@ -90,16 +163,26 @@ private:
 
   /**
    * @brief Given a model session and input vector input_data it returns
-   * the classification label (-1 or 1).
+   * the classification label (-1 or 1) of each input of the batch.
    *
    * @param session  Model loaded previusly
-   * @param input_data  Input data in form of vector of integer.
-   * @return int64_t The classification label, 1 if the first use case of the model is selected,
-   * -1 if the second one is selected.
+   * @param input_data  Input data in form of vector of integer, the batch is stored row by row.
+   * @param batch_size  Number of inputs stored in input_data.
+   * @return std::vector<int64_t> The classification labels, 1 if the first use case of the model
+   * is selected, -1 if the second one is selected.
    */
-  int64_t evaluate(Ort::Session * session, std::vector<int64_t> input_data);
+  std::vector<int64_t> evaluate(
+    Ort::Session * session, std::vector<int64_t> & input_data, int64_t batch_size = 1);
 
-  const std::map<std::string, UseCase> usecase_strings_ = {
+  /**
+   * @brief Sort the use cases by the number of models that selected them.
+   *
+   * @param votes The number of times each use case was selected.
+   * @return std::vector<UseCase> The priorities of the use cases.
+   */
+  std::vector<UseCase> sortByVotes(const std::map<std::string, int> & votes);
+
+  static inline const std::map<std::string, UseCase> usecase_strings_ = {
     {"DEAM", UseCase::WANDERING},
     {"RECA", UseCase::CHARGING},
     {"MENU", UseCase::MENU},
@@ -112,6 +195,12 @@ private:
   Ort::Env env_;
   std::vector<std::string> model_names_;
   std::vector<Ort::Session> sessions_;
+  std::unique_ptr<ShadowEvaluator> shadow_;
+
+  // Instrumentation
+  std::vector<std::chrono::nanoseconds> load_times_;
+  std::vector<LatencyHistogram> model_latencies_;
+  LatencyHistogram decision_latency_;
 };
 
 #endif  // ADAPTATIONCOMP__PREFERENCE_LEARNING_HPP_
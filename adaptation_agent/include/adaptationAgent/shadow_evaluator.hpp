@@ -0,0 +1,103 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ADAPTATIONAGENT__SHADOW_EVALUATOR_HPP_
+#define ADAPTATIONAGENT__SHADOW_EVALUATOR_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// SPDLOG
+#include "spdlog/spdlog.h"
+
+#include "adaptationAgent/spsc_queue.hpp"
+#include "adaptationAgent/types.hpp"
+
+class PreferenceLearning;
+
+/**
+ * @brief Class that evaluates a candidate set of models with the same inputs as the live ones.
+ * The inputs are received through a lock-free queue and the candidate models are evaluated
+ * in a background thread, so the live decision path is never delayed.
+ */
+class ShadowEvaluator
+{
+public:
+  /**
+   * @brief Construct a new Shadow Evaluator object and start the background thread.
+   *
+   * @param folderpath The path to the folder where the candidate ONNX models are stored.
+   * @param logger The logger where the agreement statistics and divergent cases are written.
+   */
+  ShadowEvaluator(const std::string & folderpath, std::shared_ptr<spdlog::logger> logger);
+
+  /**
+   * @brief Destroy the Shadow Evaluator object. Stop the background thread.
+   */
+  ~ShadowEvaluator();
+
+  /**
+   * @brief Submit the inputs and the live decision to be compared with the candidate models.
+   * It never blocks: if the queue is full the sample is dropped.
+   *
+   * @param input_data The input data given to the live models.
+   * @param live_priorities The priorities returned by the live models.
+   * @return bool True if the sample was queued.
+   */
+  bool submit(const std::vector<int64_t> & input_data, const std::vector<UseCase> & live_priorities);
+
+  /**
+   * @brief Log the agreement statistics and warn about the samples dropped since the
+   * last call.
+   */
+  void logStatistics();
+
+private:
+  static constexpr std::size_t kMaxInputs = 8;
+  static constexpr std::size_t kQueueSize = 256;
+  static constexpr uint64_t kStatisticsPeriod = 100;
+
+  struct Sample
+  {
+    std::array<int64_t, kMaxInputs> input;
+    uint8_t input_size;
+    UseCase live_choice;
+  };
+
+  /**
+   * @brief Main loop of the background thread.
+   */
+  void run();
+
+  std::unique_ptr<PreferenceLearning> shadow_models_;
+  std::shared_ptr<spdlog::logger> logger_;
+  SpscQueue<Sample, kQueueSize> queue_;
+  // Set by submit to wake the thread when a sample is queued
+  std::atomic<bool> pending_;
+  std::atomic<bool> running_;
+  // Samples dropped because the queue was full, and the value in the last statistics
+  std::atomic<uint64_t> dropped_;
+  uint64_t reported_dropped_;
+  uint64_t evaluated_;
+  uint64_t agreements_;
+  std::thread thread_;
+};
+
+#endif  // ADAPTATIONAGENT__SHADOW_EVALUATOR_HPP_
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ADAPTATIONAGENT__SPSC_QUEUE_HPP_
+#define ADAPTATIONAGENT__SPSC_QUEUE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free queue for one producer thread and one consumer thread.
+ * Neither side ever blocks: push fails when the queue is full and pop fails when it is empty.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Capacity The maximum number of elements. Must be a power of two.
+ */
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+public:
+  /**
+   * @brief Try to push an element into the queue. Only called from the producer thread.
+   *
+   * @param item The element to push.
+   * @return bool False if the queue is full and the element was not pushed.
+   */
+  bool try_push(T item)
+  {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    buffer_[head & (Capacity - 1)] = std::move(item);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Try to pop an element from the queue. Only called from the consumer thread.
+   *
+   * @param item The popped element.
+   * @return bool False if the queue is empty.
+   */
+  bool try_pop(T & item)
+  {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = std::move(buffer_[tail & (Capacity - 1)]);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Check if the queue is empty.
+   *
+   * @return bool True if there are no elements in the queue.
+   */
+  bool empty() const
+  {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+private:
+  std::array<T, Capacity> buffer_;
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+#endif  // ADAPTATIONAGENT__SPSC_QUEUE_HPP_
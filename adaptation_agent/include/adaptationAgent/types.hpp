@@ -16,20 +16,86 @@
 #ifndef ADAPTATIONAGENT__TYPES_HPP_
 #define ADAPTATIONAGENT__TYPES_HPP_
 
+#include <cstdint>
 #include <string>
+#include <vector>
+
+#include "../../../include/json_messages.hpp"
 
 enum UseCase { DO_NOTHING, WANDERING, CHARGING, MENU, MUSIC, NEURON_UP, GETME, REMINDER,
   ANNOUNCER, EXPLANATION };
 
+inline std::string toStr(UseCase use_case)
+{
+  if (use_case == UseCase::WANDERING) {
+    return "wandering";
+  } else if (use_case == UseCase::CHARGING) {
+    return "charging";
+  } else if (use_case == UseCase::MENU) {
+    return "menu";
+  } else if (use_case == UseCase::MUSIC) {
+    return "music";
+  } else if (use_case == UseCase::NEURON_UP) {
+    return "neuron";
+  } else if (use_case == UseCase::GETME) {
+    return "water";
+  } else if (use_case == UseCase::REMINDER) {
+    return "reminder";
+  } else if (use_case == UseCase::ANNOUNCER) {
+    return "tracking";
+  } else if (use_case == UseCase::EXPLANATION) {
+    return "explanation";
+  } else {
+    return "do_nothing";
+  }
+}
+
+// Activity of an agenda with the times as minutes of the day
+struct agendaActivity
+{
+  std::string name;
+  int start_minute;
+  int end_minute;
+};
+
+// Limits to the changes of use case
+struct switchingPolicy
+{
+  // Battery level to start charging and to stop it
+  float battery_low = 10.0;
+  float battery_recovered = 20.0;
+  // Minimum time in ms a use case that is not idle runs before switching to another one
+  int min_dwell = 10000;
+  // Time in ms a new use case must be selected before switching to it
+  int debounce = 1000;
+};
+
+// Data of a person that comes from one attribute of its node
+enum class PersonField { COMM_PARAMETERS, PROFILE, ACTIVITIES, MENU, NEURON, REMINDER };
+
+// Use case selected for a person and the inputs it was computed with
+struct userDecision
+{
+  uint64_t person_version;
+  uint64_t agenda_version;
+  int minute;
+  UseCase use_case;
+  int score;
+  // Inputs of the models for the person
+  std::vector<int64_t> inputs;
+};
+
 struct personData
 {
   std::string identifier;
-  std::string commParameters;
-  std::string profile;
-  std::string activities;
+  CommParameters commParameters{};
+  Profile profile{};
+  std::vector<agendaActivity> activities;
   std::string menu;
-  bool neuron;
-  bool reminder;
+  bool neuron = false;
+  bool reminder = false;
+  // Incremented each time an attribute of the person changes
+  uint64_t version = 0;
 };
 
 #endif  // ADAPTATIONAGENT__TYPES_HPP_
@@ -0,0 +1,110 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ADAPTATIONAGENT__USE_CASE_SCHEDULER_HPP_
+#define ADAPTATIONAGENT__USE_CASE_SCHEDULER_HPP_
+
+#include <chrono>
+#include <map>
+#include <optional>
+
+#include "adaptationAgent/types.hpp"
+
+/**
+ * @brief Decide when the agent can switch to the selected use case.
+ * A new use case must be selected during the debounce window before switching to it and
+ * the current use case runs at least its minimum dwell time. Charging and the use cases
+ * requested with a button are never debounced.
+ */
+class UseCaseScheduler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Construct a new Use Case Scheduler object.
+   *
+   * @param min_dwell Minimum time a use case runs before switching to another one.
+   * @param debounce Time a new use case must be selected before switching to it.
+   */
+  explicit UseCaseScheduler(
+    std::chrono::milliseconds min_dwell = std::chrono::milliseconds(0),
+    std::chrono::milliseconds debounce = std::chrono::milliseconds(0));
+
+  /**
+   * @brief Set the minimum dwell time and the debounce window.
+   *
+   * @param min_dwell Minimum time a use case runs before switching to another one, unless
+   * it has its own dwell time.
+   * @param debounce Time a new use case must be selected before switching to it.
+   */
+  void setPolicy(std::chrono::milliseconds min_dwell, std::chrono::milliseconds debounce);
+
+  /**
+   * @brief Set the minimum dwell time of a use case.
+   *
+   * @param use_case The use case.
+   * @param min_dwell Minimum time the use case runs before switching to another one.
+   */
+  void setDwell(UseCase use_case, std::chrono::milliseconds min_dwell);
+
+  /**
+   * @brief Check if the agent must switch to the selected use case now.
+   *
+   * @param current The use case running.
+   * @param selected The use case selected by the last decision.
+   * @param now The current time.
+   * @param debounce False if the use case was requested explicitly, for example with a button.
+   * @return bool True if the switch must be done now.
+   */
+  bool shouldSwitch(
+    UseCase current, UseCase selected, Clock::time_point now, bool debounce = true);
+
+  /**
+   * @brief Get the time until the pending switch is allowed.
+   *
+   * @param now The current time.
+   * @return std::chrono::milliseconds The time left or zero if there isn't a pending switch.
+   */
+  std::chrono::milliseconds remaining(Clock::time_point now) const;
+
+  /**
+   * @brief Start the dwell time of a new use case.
+   *
+   * @param use_case The new use case.
+   * @param now The time of the switch.
+   */
+  void switched(UseCase use_case, Clock::time_point now);
+
+  /**
+   * @brief The current use case has finished, so the dwell time no longer applies.
+   */
+  void release();
+
+private:
+  std::chrono::milliseconds min_dwell_;
+  std::chrono::milliseconds debounce_;
+  // Use cases with their own minimum dwell time
+  std::map<UseCase, std::chrono::milliseconds> dwells_;
+  // Start and dwell time of the current use case, if it is still running
+  std::optional<Clock::time_point> dwell_start_;
+  std::chrono::milliseconds dwell_;
+  // Use case waiting to be switched to, when it was first selected and if it is debounced
+  std::optional<UseCase> pending_;
+  Clock::time_point pending_since_;
+  bool pending_debounce_;
+};
+
+#endif  // ADAPTATIONAGENT__USE_CASE_SCHEDULER_HPP_
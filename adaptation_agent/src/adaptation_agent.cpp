@@ -16,7 +16,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <limits>
+#include <utility>
 
 #include "nlohmann/json.hpp"
 
@@ -31,6 +33,15 @@ AdaptationAgent::AdaptationAgent(std::string agent_name, int agent_id, std::stri
 {
   // Compute
   QObject::connect(&timer_, SIGNAL(timeout()), this, SLOT(compute()));
+  QObject::connect(&agenda_timer_, SIGNAL(timeout()), this, SLOT(compute()));
+  QObject::connect(&compute_trigger_, SIGNAL(timeout()), this, SLOT(compute()));
+  QObject::connect(&switch_timer_, SIGNAL(timeout()), this, SLOT(compute()));
+  agenda_timer_.setSingleShot(true);
+  compute_trigger_.setSingleShot(true);
+  switch_timer_.setSingleShot(true);
+  dirty_inputs_ = 0;
+  published_sequence_ = 0;
+  clock_ = std::make_unique<SystemMinuteClock>();
 
   // Register types
   qRegisterMetaType<DSR::Node>("Node");
@@ -61,96 +72,171 @@ AdaptationAgent::AdaptationAgent(std::string agent_name, int agent_id, std::stri
   QObject::connect(
     G_.get(), &DSR::DSRGraph::create_edge_signal, this, &AdaptationAgent::edge_created);
 
+  // Index the actions already requested by the use case being performed
+  if (auto use_case_node = G_->get_node("use_case"); use_case_node.has_value()) {
+    use_case_id_ = use_case_node.value().id();
+    for (const std::string type : {"wants_to", "is_performing"}) {
+      for (const auto & edge : G_->get_edges_by_type(type)) {
+        trackActionEdge(edge.from(), edge.to(), type);
+      }
+    }
+  }
+
   // Initialize the use case
   previous_use_case_ = UseCase::DO_NOTHING;
   current_use_case_ = UseCase::DO_NOTHING;
   use_case_finished_ = false;
+  robot_agenda_version_ = 0;
+
+  // Initialize the battery level and the requests with the nodes already in the graph
+  battery_level_ = kDefaultBatteryLevel;
+  if (auto battery_node = G_->get_node("battery"); battery_node.has_value()) {
+    auto battery_level = G_->get_attrib_by_name<battery_percentage_att>(battery_node.value());
+    if (battery_level.has_value()) {
+      battery_level_ = battery_level.value();
+    }
+  }
+  bring_water_present_ = G_->get_node("bring_water").has_value();
+  tracking_present_ = G_->get_node("tracking").has_value();
+  explanation_present_ = G_->get_node("explanation").has_value();
 }
 
 AdaptationAgent::~AdaptationAgent()
 {
+  // Stop the decisions before the graph they are applied to
+  decision_engine_.reset();
   G_.reset();
   logger_->info("Destroying AdaptationAgent");
 }
 
-void AdaptationAgent::initializeLogger(std::string log_filepath)
+void AdaptationAgent::initializeLogger(std::string log_filepath, const loggerParameters & params)
 {
   // Initialize logger
   std::string log_folder = log_filepath + std::to_string(std::time(nullptr)) + "/" + agent_name_;
+  log_folder_ = log_folder;
+  logger_params_ = params;
   std::string log_folder_expl =
     log_filepath + std::to_string(std::time(nullptr)) + "/explicability";
   std::string debug_log_file = log_folder + "/debug.log";
   std::string explicability_log_file = log_folder_expl + "/explicability.log";
-  console_sink_ = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-  debug_file_sink_ = std::make_shared<spdlog::sinks::basic_file_sink_mt>(debug_log_file, true);
-  logger_ = std::make_unique<spdlog::logger>(
-    agent_name_, spdlog::sinks_init_list{console_sink_, debug_file_sink_});
-  explicability_file_sink_ = std::make_shared<spdlog::sinks::basic_file_sink_mt>(
-    explicability_log_file, true);
-  expl_logger_ = std::make_unique<spdlog::logger>(
-    "explicability", spdlog::sinks_init_list{console_sink_, explicability_file_sink_});
-
-  debug_file_sink_->set_level(spdlog::level::debug);
-  logger_->set_level(spdlog::level::info);
+  // The messages are written to the console and the files by the logging thread
+  console_sink_ = createConsoleSink(params);
+  debug_file_sink_ = createFileSink(debug_log_file, params);
+  logger_ = createAsyncLogger(agent_name_, {console_sink_, debug_file_sink_}, params);
+  explicability_file_sink_ = createFileSink(explicability_log_file, params);
   explicability_file_sink_->set_level(spdlog::level::info);
-  expl_logger_->set_level(spdlog::level::info);
+  expl_logger_ = createAsyncLogger(
+    "explicability", {console_sink_, explicability_file_sink_}, params);
 
   logger_->info("Initialize adaptation agent");
 }
 
-void AdaptationAgent::initializeAdaptation(std::string models)
+void AdaptationAgent::setClock(std::unique_ptr<MinuteClock> clock)
+{
+  clock_ = std::move(clock);
+  int minute = clock_->minuteOfDay();
+  logger_->info("Clock changed. Current time: {:02}:{:02}", minute / 60, minute % 60);
+}
+
+void AdaptationAgent::setSwitchingPolicy(const switchingPolicy & policy)
 {
-  pref_learning_ = std::make_unique<PreferenceLearning>();
-  pref_learning_->loadSessions(models);
+  switching_policy_ = policy;
+  scheduler_.setPolicy(
+    std::chrono::milliseconds(policy.min_dwell), std::chrono::milliseconds(policy.debounce));
+  // The robot leaves the idle use cases as soon as there is something to do
+  for (int i = UseCase::DO_NOTHING; i <= UseCase::EXPLANATION; ++i) {
+    if (notWaitUseCase(UseCase(i))) {
+      scheduler_.setDwell(UseCase(i), std::chrono::milliseconds(0));
+    }
+  }
+  logger_->info(
+    "Charging from {}% to {}%. Minimum dwell {} ms and debounce {} ms", policy.battery_low,
+    policy.battery_recovered, policy.min_dwell, policy.debounce);
+}
+
+void AdaptationAgent::initializeAdaptation(
+  std::string models, std::string shadow_models, int safety_period)
+{
+  auto pref_learning = std::make_unique<PreferenceLearning>();
+  pref_learning->loadSessions(models);
+  // The candidate models only write to their own log file
+  if (!shadow_models.empty()) {
+    auto shadow_file_sink = createFileSink(log_folder_ + "/shadow.log", logger_params_);
+    shadow_file_sink->set_level(spdlog::level::info);
+    shadow_logger_ = createAsyncLogger("shadow", {shadow_file_sink}, logger_params_);
+    pref_learning->loadShadowSessions(shadow_models, shadow_logger_);
+    logger_->info("Shadow evaluation enabled with models from {}", shadow_models);
+  }
   enviroment_data_ = {0, 0, 0, 0};
-  timer_.start(100);
+  decision_trace_.startDumper(expl_logger_.get());
+  // The graph is only modified from the Qt thread
+  decision_engine_ = std::make_unique<DecisionEngine>(
+    std::move(pref_learning), switching_policy_.battery_low,
+    switching_policy_.battery_recovered, &decision_trace_, logger_.get(),
+    [this](const decisionResult & result) {
+      QMetaObject::invokeMethod(
+        this, [this, result]() {applyDecision(result);}, Qt::QueuedConnection);
+    });
+  // The compute is triggered by the changes of the inputs. This is only a backstop
+  timer_.start(safety_period);
+  compute_trigger_.start(0);
 }
 
 void AdaptationAgent::compute()
 {
-  std::vector<int> value_use_cases;
-  std::vector<UseCase> use_cases;
-
-  // Execute preference learning
-  if (!priorityUseCase(selected_use_case_)) {
-    if (!plannedGroupUseCase(selected_use_case_)) {
-      // Sólo habilitado con wandering, no quita el recargar o el terapia.
-      if (!buttonPushedUseCase(selected_use_case_)) {
-        // There isn't a person interacting with the robot
-        if (interacting_person_.identifier.empty()) {
-          // Elegimos persona y caso de uso
-          for (size_t i = 0; i < people_with_robot_.size(); i++) {
-            use_cases.push_back(selectedUseCaseForUser(i));
-            logger_->info("Use case for user {} is : {}", i, toStr(selectedUseCaseForUser(i)));
-            value_use_cases.push_back(evaluate(use_cases.back()));
-            logger_->info("Evaluate use case: {}", evaluate(use_cases.back()));
-          }
-          if (use_cases.size() == 0) {
-            selected_use_case_ = UseCase::WANDERING;
-          } else {
-            auto max_iter = std::max_element(value_use_cases.begin(), value_use_cases.end());
-            int max_index = std::distance(value_use_cases.begin(), max_iter);
-            selected_use_case_ = use_cases.at(max_index);
-            current_person_use_case_ = people_with_robot_[max_index];
-            // std::cout << "max_index: " << max_index << "selected_use_case_: " << toStr(
-            //   selected_use_case_) << "current_person_use_case_: " <<
-            //   current_person_use_case_.identifier << std::endl;
-          }
-          logger_->info("Selected use case: {}", toStr(selected_use_case_));
-        }
-      } else {
-        logger_->info("Button pushed: water / tracking");
-      }
-    } else {
-      logger_->info("Group planned: musical therapy");
+  logger_->debug("Compute triggered by inputs {:#x}", dirty_inputs_);
+  dirty_inputs_ = 0;
+  compute_trigger_.stop();
+  last_compute_ = std::chrono::steady_clock::now();
+  if (!decision_engine_) {
+    return;
+  }
+
+  // The decision is taken in the thread of the engine with a copy of the inputs
+  auto inputs = std::make_shared<decisionInputs>();
+  inputs->sequence = ++published_sequence_;
+  inputs->minute = clock_->minuteOfDay();
+  inputs->battery_level = battery_level_;
+  inputs->bring_water_present = bring_water_present_;
+  inputs->tracking_present = tracking_present_;
+  inputs->explanation_present = explanation_present_;
+  inputs->robot_activities = robot_activities_;
+  inputs->robot_agenda_version = robot_agenda_version_;
+  inputs->person_interacting = !interacting_person_.identifier.empty();
+  inputs->people.reserve(people_with_robot_.size());
+  for (const auto & [node_id, person] : people_with_robot_) {
+    inputs->people.push_back(person);
+  }
+  decision_engine_->publish(std::move(inputs));
+
+  armAgendaTimer();
+}
+
+void AdaptationAgent::applyDecision(const decisionResult & result)
+{
+  // Newer inputs are being evaluated, so this decision is already outdated
+  if (result.sequence < published_sequence_) {
+    logger_->debug("Discarding outdated decision {}", result.sequence);
+    return;
+  }
+
+  if (result.use_case.has_value()) {
+    selected_use_case_ = result.use_case.value();
+  }
+  if (!result.person.empty()) {
+    if (auto person = people_with_robot_.find(result.person); person != nullptr) {
+      current_person_use_case_ = *person;
     }
-  } else {
-    logger_->info("Priority: charging");
   }
   logger_->debug("Selected use case: {}", toStr(selected_use_case_));
 
   // Activamos persona y caso de uso
-  if (selected_use_case_ != current_use_case_) {
+  auto now = std::chrono::steady_clock::now();
+  // A button is an explicit request, so it is not debounced
+  if (scheduler_.shouldSwitch(
+      current_use_case_, selected_use_case_, now, result.rule != DecisionRule::BUTTON))
+  {
+    switch_timer_.stop();
     if (selected_use_case_ == UseCase::DO_NOTHING) {
       use_case_finished_ = true;
     }
@@ -162,7 +248,74 @@ void AdaptationAgent::compute()
     // edge callback
     setNewUseCaseInDsr(toStr(selected_use_case_));
     current_use_case_ = selected_use_case_;
+    scheduler_.switched(current_use_case_, now);
     // curr = sele = do noth, use_case_finish=false
+  } else if (auto wait = scheduler_.remaining(now); wait.count() > 0) {
+    // Check again when the switch is allowed
+    logger_->debug("Switch to {} delayed {} ms", toStr(selected_use_case_), wait.count());
+    switch_timer_.start(static_cast<int>(wait.count()));
+  } else {
+    switch_timer_.stop();
+  }
+}
+
+void AdaptationAgent::markDirty(DirtyInput input)
+{
+  dirty_inputs_ |= input;
+  if (!compute_trigger_.isActive()) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - last_compute_);
+    auto wait = std::max(kMinComputeInterval - elapsed, std::chrono::milliseconds(0));
+    compute_trigger_.start(static_cast<int>(wait.count()));
+  }
+}
+
+void AdaptationAgent::armAgendaTimer()
+{
+  // Minutes of the day when the result of findActivityInAgenda or isPersonBusy can change
+  std::vector<int> boundaries;
+  for (const auto & act : robot_activities_) {
+    boundaries.push_back(act.start_minute);
+    boundaries.push_back(act.end_minute);
+  }
+  for (const auto & [node_id, person] : people_with_robot_) {
+    for (const auto & act : person.activities) {
+      boundaries.push_back(act.start_minute - DecisionEngine::kBusyPretime);
+      boundaries.push_back(act.end_minute - DecisionEngine::kBusyPretime);
+    }
+  }
+
+  // Find the closest boundary in the future
+  constexpr int kMinutesPerDay = MinuteClock::kMinutesPerDay;
+  int now_minutes = clock_->minuteOfDay();
+  int next = kMinutesPerDay;
+  for (const auto & boundary : boundaries) {
+    int delta = ((boundary - now_minutes) % kMinutesPerDay + kMinutesPerDay) % kMinutesPerDay;
+    if (delta > 0) {
+      next = std::min(next, delta);
+    }
+  }
+
+  if (next == kMinutesPerDay) {
+    agenda_timer_.stop();
+  } else {
+    agenda_timer_.start(static_cast<int>(clock_->untilMinutes(next).count()));
+  }
+}
+
+bool AdaptationAgent::isButtonNode(const std::string & node_name)
+{
+  return node_name == "bring_water" || node_name == "tracking" || node_name == "explanation";
+}
+
+void AdaptationAgent::setButtonPresent(const std::string & node_name, bool present)
+{
+  if (node_name == "bring_water") {
+    bring_water_present_ = present;
+  } else if (node_name == "tracking") {
+    tracking_present_ = present;
+  } else if (node_name == "explanation") {
+    explanation_present_ = present;
   }
 }
 
@@ -190,59 +343,66 @@ void AdaptationAgent::abortCurrentUseCaseInDsr()
       }
     }
   }
-
-  // Replace all 'wants_to' edges with 'cancel'.
-  // Add 'CANCELED' to result_code attribute.
-  logger_->info("Replace all 'wants_to' edges with 'cancel");
-  std::vector<DSR::Edge> edges = G_->get_edges_by_type("wants_to");
-  for (const auto & edge: edges) {
-    auto to_node = G_->get_node(edge.to());
-    if (to_node.has_value()) {
-      if (to_node.value().name() == "tracking" || to_node.value().type() == "bring_water" ||
-        to_node.value().type() == "explanation")
-      {
-        logger_->debug("Dont cancel [{}]", to_node.value().name());
-      } else {
-        // Replace the 'wants_to' edge with a 'cancel' edge between robot and action
-        if (DSR::replace_edge<cancel_edge_type>(G_, edge.from(), edge.to(), "wants_to", robot_name_)) {
-          // Add result_code attribute to the node
-          std::string result_code = "CANCELED: by adaptation agent";
-          G_->add_or_modify_attrib_local<result_code_att>(to_node.value(), result_code);
-          G_->update_node(to_node.value());
-          expl_logger_->info(
-            "CANCEL [{}] action by Adaptation because aborting currente use case {}",
-            to_node.value().name(), toStr(previous_use_case_));
-          logger_->info("CANCEL [{}] by adaptation agent", to_node.value().name());
-        }
+  use_case_id_.reset();
+
+  // Replace the 'wants_to' edges of the actions of the use case with 'cancel' and
+  // the 'is_performing' edges with 'abort'. Add the result_code attribute to the actions.
+  logger_->info("Cancel or abort {} action edges", action_edges_.size());
+  auto action_edges = std::exchange(action_edges_, {});
+  for (const auto & [from, to, type] : action_edges) {
+    auto to_node = G_->get_node(to);
+    if (!to_node.has_value()) {
+      continue;
+    }
+    if (type == "wants_to") {
+      // Replace the 'wants_to' edge with a 'cancel' edge between robot and action
+      if (DSR::replace_edge<cancel_edge_type>(G_, from, to, "wants_to", robot_name_)) {
+        std::string result_code = "CANCELED: by adaptation agent";
+        G_->add_or_modify_attrib_local<result_code_att>(to_node.value(), result_code);
+        G_->update_node(to_node.value());
+        expl_logger_->info(
+          "CANCEL [{}] action by Adaptation because aborting currente use case {}",
+          to_node.value().name(), toStr(previous_use_case_));
+        logger_->info("CANCEL [{}] by adaptation agent", to_node.value().name());
+      }
+    } else {
+      // Replace the 'is_performing' edge with a 'abort' edge between robot and action
+      if (DSR::replace_edge<abort_edge_type>(G_, from, to, "is_performing", robot_name_)) {
+        std::string result_code = "ABORTED: by adaptation agent";
+        G_->add_or_modify_attrib_local<result_code_att>(to_node.value(), result_code);
+        G_->update_node(to_node.value());
+        expl_logger_->info(
+          "ABORT [{}] action by Adaptation because aborting currente use case {}",
+          to_node.value().name(), toStr(previous_use_case_));
+        logger_->info("ABORT [{}] by adaptation agent", to_node.value().name());
       }
     }
   }
+}
 
-  // Replace all 'is_performing' edges with 'abort'.
-  // Add 'ABORTED' to result_code attribute.
-  logger_->info("Replace all 'is_performing' edges with 'abort'");
-  edges = G_->get_edges_by_type("is_performing");
-  for (const auto & edge: edges) {
-    auto to_node = G_->get_node(edge.to());
-    if (to_node.has_value()) {
-      if (to_node.value().name() == "tracking" || to_node.value().type() == "update_bbdd") {
-        logger_->debug("Dont abort [{}]", to_node.value().name());
-      } else {
-        // Replace the 'is_performing' edge with a 'abort' edge between robot and action
-        if (DSR::replace_edge<abort_edge_type>(
-            G_, edge.from(), edge.to(), "is_performing", robot_name_))
-        {
-          // Add result_code attribute to the node
-          std::string result_code = "ABORTED: by adaptation agent";
-          G_->add_or_modify_attrib_local<result_code_att>(to_node.value(), result_code);
-          G_->update_node(to_node.value());
-          expl_logger_->info(
-            "ABORT [{}] action by Adaptation because aborting currente use case {}",
-            to_node.value().name(), toStr(previous_use_case_));
-          logger_->info("ABORT [{}] by adaptation agent", to_node.value().name());
-        }
-      }
-    }
+bool AdaptationAgent::isActionEdge(const std::string & edge_type, const DSR::Node & to_node)
+{
+  // The use case itself and the requests of the buttons are not aborted with the use case
+  if (to_node.name() == "use_case" || to_node.name() == "tracking") {
+    return false;
+  }
+  if (edge_type == "wants_to") {
+    return to_node.type() != "bring_water" && to_node.type() != "explanation";
+  } else if (edge_type == "is_performing") {
+    return to_node.type() != "update_bbdd";
+  }
+  return false;
+}
+
+void AdaptationAgent::trackActionEdge(
+  std::uint64_t from, std::uint64_t to, const std::string & type)
+{
+  // The actions requested without a use case belong to other agents
+  if (!use_case_id_.has_value() || (type != "wants_to" && type != "is_performing")) {
+    return;
+  }
+  if (auto to_node = G_->get_node(to); to_node.has_value() && isActionEdge(type, to_node.value())) {
+    action_edges_.emplace(from, to, type);
   }
 }
 
@@ -256,6 +416,9 @@ bool AdaptationAgent::setNewUseCaseInDsr(const std::string & new_use_case)
   auto robot_node = G_->get_node(robot_name_);
   auto new_node = DSR::Node::create<use_case_node_type>("use_case");
   if (auto id = G_->insert_node(new_node); id.has_value()) {
+    // The actions requested from now on belong to the new use case
+    use_case_id_ = id.value();
+    action_edges_.clear();
     auto new_edge = DSR::Edge::create<wants_to_edge_type>(robot_node.value().id(), new_node.id());
     G_->insert_or_assign_edge(new_edge);
     // Modify the attributes of the new node
@@ -298,64 +461,48 @@ void AdaptationAgent::node_attributes_updated(
       auto robot_activities = G_->get_attrib_by_name<activities_att>(node.value());
       if (robot_activities.has_value()) {
         robot_agenda_ = robot_activities.value();
+        robot_activities_ = parseAgenda(robot_agenda_);
+        robot_agenda_version_++;
         expl_logger_->info("Activities for today are: {}", robot_activities.value());
         logger_->info("Robot Activities changed: {}", robot_activities.value());
+        markDirty(DirtyInput::AGENDA);
       }
     }
   }
 
+  // Check if the battery level has changed
+  if (node.has_value() && node.value().name() == "battery") {
+    if (std::find(att_names.begin(), att_names.end(), "battery_percentage") != att_names.end()) {
+      auto battery_level = G_->get_attrib_by_name<battery_percentage_att>(node.value());
+      if (battery_level.has_value()) {
+        battery_level_ = battery_level.value();
+      }
+      markDirty(DirtyInput::BATTERY);
+    }
+  }
+
   // Check if a person node changed
   if (node.has_value() && node.value().type() == "person") {
     auto person_name = G_->get_attrib_by_name<identifier_att>(node.value());
-    auto person_comm = G_->get_attrib_by_name<comm_parameters_att>(node.value());
-    auto person_profile = G_->get_attrib_by_name<skills_parameters_att>(node.value());
-    auto person_activities = G_->get_attrib_by_name<activities_att>(node.value());
-    auto person_menu = G_->get_attrib_by_name<menu1_att>(node.value());
-    auto person_neuron = G_->get_attrib_by_name<neuron_att>(node.value());
-    auto person_reminder = G_->get_attrib_by_name<reminder_att>(node.value());
     // Check if the person is identified
     if (person_name.has_value()) {
-      // If the person is interacting with the robot
+      // If the person is interacting with the robot, only the changed attributes are updated
       if (person_name.value() == interacting_person_.identifier) {
-        if (person_comm.has_value()) {interacting_person_.commParameters = person_comm.value();}
-        if (person_profile.has_value()) {interacting_person_.profile = person_profile.value();}
-        if (person_activities.has_value()) {
-          interacting_person_.activities = person_activities.value();
+        if (updatePersonFromNode(interacting_person_, node.value(), att_names)) {
+          markDirty(DirtyInput::PEOPLE);
         }
-        if (person_menu.has_value()) {interacting_person_.menu = person_menu.value();}
-        if (person_neuron.has_value()) {interacting_person_.neuron = person_neuron.value();}
-        if (person_reminder.has_value()) {interacting_person_.reminder = person_reminder.value();}
        // expl_logger_->info("The attributes of {} have changed", interacting_person_.identifier);
       }
-      // or the robot is just with the person
-      else {
-        // Check if the person is already in the list
-        auto it = std::find_if(
-          people_with_robot_.begin(), people_with_robot_.end(),
-          [person_name](const auto & person) {
-            return person.identifier == person_name.value();
-          });
-        // Update the person in the list or add it
-        if (it != people_with_robot_.end()) {
-          if (person_comm.has_value()) {it->commParameters = person_comm.value();}
-          if (person_profile.has_value()) {it->profile = person_profile.value();}
-          if (person_activities.has_value()) {it->activities = person_activities.value();}
-          if (person_menu.has_value()) {it->menu = person_menu.value();}
-          if (person_neuron.has_value()) {it->neuron = person_neuron.value();}
-          if (person_reminder.has_value()) {it->reminder = person_reminder.value();}
-        } else {
-          personData current_person;
-          if (person_name.has_value()) {current_person.identifier = person_name.value();}
-          if (person_comm.has_value()) {current_person.commParameters = person_comm.value();}
-          if (person_profile.has_value()) {current_person.profile = person_profile.value();}
-          if (person_activities.has_value()) {
-            current_person.activities = person_activities.value();
-          }
-          if (person_menu.has_value()) {current_person.menu = person_menu.value();}
-          if (person_neuron.has_value()) {current_person.neuron = person_neuron.value();}
-          if (person_reminder.has_value()) {current_person.reminder = person_reminder.value();}
-          people_with_robot_.push_back(current_person);
+      // or the robot is just with the person. Update the person in the list or add it
+      else if (auto stored = people_with_robot_.find(id); stored != nullptr) {
+        bool renamed = stored->identifier != person_name.value();
+        auto & person = people_with_robot_.insert(id, person_name.value());
+        if (updatePersonFromNode(person, node.value(), att_names) || renamed) {
+          markDirty(DirtyInput::PEOPLE);
         }
+      } else {
+        updatePersonFromNode(people_with_robot_.insert(id, person_name.value()), node.value());
+        markDirty(DirtyInput::PEOPLE);
       }
     }
   }
@@ -364,6 +511,8 @@ void AdaptationAgent::node_attributes_updated(
 void AdaptationAgent::edge_updated(
   std::uint64_t from, std::uint64_t to, const std::string & type)
 {
+  trackActionEdge(from, to, type);
+
   // Check if the robot is performing a new use case: robot ---(is_performing)---> use_case
   if (type == "is_performing") {
     auto robot_node = G_->get_node(from);
@@ -392,10 +541,16 @@ void AdaptationAgent::edge_updated(
           "Finished the use case {} with the result: {}", use_case_id.value(), result_code.value());
       }
       logger_->info("Finished detected for use case: {}", toStr(current_use_case_));
+      if (use_case_id_ == to) {
+        use_case_id_.reset();
+        action_edges_.clear();
+      }
       use_case_finished_ = true;
+      scheduler_.release();
       if (current_use_case_ != UseCase::DO_NOTHING) {
         selected_use_case_ = UseCase::DO_NOTHING;
       }
+      markDirty(DirtyInput::USE_CASE);
       auto water_node = G_->get_node("bring_water");
       if (water_node.has_value()) {
         // Replace the 'is_performing' edge with a 'abort' edge between robot and action
@@ -404,7 +559,9 @@ void AdaptationAgent::edge_updated(
         {
           // Add result_code attribute to the node
           // And delete the node
-          if (!G_->delete_node("bring_water")) {
+          if (G_->delete_node("bring_water")) {
+            setButtonPresent("bring_water", false);
+          } else {
             std::cout << "The node [";
             std::cout << water_node.value().name();
             std::cout << "] couldn't be deleted" << std::endl;
@@ -419,7 +576,9 @@ void AdaptationAgent::edge_updated(
         {
           // Add result_code attribute to the node
           // And delete the node
-          if (!G_->delete_node("explanation")) {
+          if (G_->delete_node("explanation")) {
+            setButtonPresent("explanation", false);
+          } else {
             std::cout << "The node [";
             std::cout << explanation_node.value().name();
             std::cout << "] couldn't be deleted" << std::endl;
@@ -435,7 +594,9 @@ void AdaptationAgent::edge_updated(
           // Add result_code attribute to the node
         }
         // And delete the node
-        if (!G_->delete_node("tracking")) {
+        if (G_->delete_node("tracking")) {
+          setButtonPresent("tracking", false);
+        } else {
           std::cout << "The node [";
           std::cout << tracking_node.value().name();
           std::cout << "] couldn't be deleted" << std::endl;
@@ -450,33 +611,32 @@ void AdaptationAgent::edge_updated(
     if (robot_node.has_value() && robot_node.value().name() == robot_name_ &&
       person_node.has_value() && person_node.value().type() == "person")
     {
-      // Get the attributes of the person node
-      auto person_name = G_->get_attrib_by_name<identifier_att>(person_node.value());
-      auto person_comm = G_->get_attrib_by_name<comm_parameters_att>(person_node.value());
-      auto person_profile = G_->get_attrib_by_name<skills_parameters_att>(person_node.value());
-      auto person_activities = G_->get_attrib_by_name<activities_att>(person_node.value());
-      auto person_menu = G_->get_attrib_by_name<menu1_att>(person_node.value());
-      auto person_neuron = G_->get_attrib_by_name<neuron_att>(person_node.value());
       // Updates person interacting attribute
+      auto person_name = G_->get_attrib_by_name<identifier_att>(person_node.value());
       if (person_name.has_value()) {interacting_person_.identifier = person_name.value();}
-      if (person_comm.has_value()) {interacting_person_.commParameters = person_comm.value();}
-      if (person_profile.has_value()) {interacting_person_.profile = person_profile.value();}
-      if (person_activities.has_value()) {
-        interacting_person_.activities = person_activities.value();
-      }
-      if (person_menu.has_value()) {interacting_person_.menu = person_menu.value();}
-      if (person_neuron.has_value()) {interacting_person_.neuron = person_neuron.value();}
-      expl_logger_->info("The person {} is interacting with me", person_name.value());
+      updatePersonFromNode(interacting_person_, person_node.value());
+      expl_logger_->info("The person {} is interacting with me", interacting_person_.identifier);
+      markDirty(DirtyInput::PEOPLE);
     }
   }
   // Check if the person is around the robot:  person ---(is_with)---> robot
   else if (type == "is_with") {
   }
+  // Check if a button has been pushed: robot ---(wants_to)---> bring_water/tracking/explanation
+  else if (type == "wants_to") {
+    auto to_node = G_->get_node(to);
+    if (to_node.has_value() && isButtonNode(to_node.value().name())) {
+      setButtonPresent(to_node.value().name(), true);
+      markDirty(DirtyInput::BUTTONS);
+    }
+  }
 }
 
 void AdaptationAgent::edge_deleted(
   std::uint64_t from, std::uint64_t to, const std::string & edge_tag)
 {
+  action_edges_.erase({from, to, edge_tag});
+
   // Check if the person interacting with the robot is gone: person ---(!interacting)---> robot
   if (edge_tag == "interacting") {
     auto robot_node = G_->get_node(from);
@@ -490,10 +650,11 @@ void AdaptationAgent::edge_deleted(
       expl_logger_->info(
         "The person {} finish interacting with robot", interacting_person_.identifier);
       interacting_person_ = personData();
+      markDirty(DirtyInput::PEOPLE);
     }
   }
   // Check if the person with the robot is gone: robot ---(!is_with)---> person
-  else if ("is_with") {
+  else if (edge_tag == "is_with") {
     auto robot_node = G_->get_node(to);
     auto person_node = G_->get_node(from);
     if (robot_node.has_value() && robot_node.value().name() == robot_name_ &&
@@ -502,37 +663,47 @@ void AdaptationAgent::edge_deleted(
       // Get the attributes of the person node
       auto person_name = G_->get_attrib_by_name<identifier_att>(person_node.value());
       // Remove the person from the list
-      std::cout << "Tamaño inicio = " << people_with_robot_.size() << std::endl;
-      people_with_robot_.erase(
-        std::remove_if(
-          people_with_robot_.begin(), people_with_robot_.end(),
-          [person_name](const auto & person) {
-            return person.identifier == person_name.value();
-          }), people_with_robot_.end());
-      logger_->info("Person node {} deleted", person_name.value());
+      logger_->debug("People with the robot before the removal: {}", people_with_robot_.size());
+      people_with_robot_.erase(from);
+      logger_->info("Person node {} deleted", person_name.value_or(std::to_string(from)));
+      markDirty(DirtyInput::PEOPLE);
     }
   }
 }
 
 void AdaptationAgent::node_deleted(const DSR::Node & node)
 {
+  // The edges of the node are deleted with it
+  std::erase_if(
+    action_edges_, [&node](const auto & edge) {
+      return std::get<0>(edge) == node.id() || std::get<1>(edge) == node.id();
+    });
+  if (use_case_id_ == node.id()) {
+    use_case_id_.reset();
+    action_edges_.clear();
+  }
+
   if (node.type() == "person") {
     // Get the attributes of the person node
     auto person_name = G_->get_attrib_by_name<identifier_att>(node);
     // Remove the person from the list
-    people_with_robot_.erase(
-      std::remove_if(
-        people_with_robot_.begin(), people_with_robot_.end(),
-        [person_name](const auto & person) {
-          return person.identifier == person_name.value();
-        }), people_with_robot_.end());
-    logger_->info("Person node {} deleted", person_name.value());
+    people_with_robot_.erase(node.id());
+    logger_->info("Person node {} deleted", person_name.value_or(std::to_string(node.id())));
+    markDirty(DirtyInput::PEOPLE);
+  } else if (isButtonNode(node.name())) {
+    setButtonPresent(node.name(), false);
+    markDirty(DirtyInput::BUTTONS);
+  } else if (node.name() == "battery") {
+    battery_level_ = kDefaultBatteryLevel;
+    markDirty(DirtyInput::BATTERY);
   }
 }
 
 void AdaptationAgent::edge_created(
   std::uint64_t from, std::uint64_t to, const std::string & type)
 {
+  trackActionEdge(from, to, type);
+
   // Check if the robot is interacing with a person: robot ---(interacting)---> person
   if (type == "interacting") {
     auto robot_node = G_->get_node(from);
@@ -540,22 +711,11 @@ void AdaptationAgent::edge_created(
     if (robot_node.has_value() && robot_node.value().name() == robot_name_ &&
       person_node.has_value() && person_node.value().type() == "person")
     {
-      // Get the attributes of the person node
-      auto person_name = G_->get_attrib_by_name<identifier_att>(person_node.value());
-      auto person_comm = G_->get_attrib_by_name<comm_parameters_att>(person_node.value());
-      auto person_profile = G_->get_attrib_by_name<skills_parameters_att>(person_node.value());
-      auto person_activities = G_->get_attrib_by_name<activities_att>(person_node.value());
-      auto person_menu = G_->get_attrib_by_name<menu1_att>(person_node.value());
-      auto person_reminder = G_->get_attrib_by_name<reminder_att>(person_node.value());
       // Updates person interacting attribute
+      auto person_name = G_->get_attrib_by_name<identifier_att>(person_node.value());
       if (person_name.has_value()) {interacting_person_.identifier = person_name.value();}
-      if (person_comm.has_value()) {interacting_person_.commParameters = person_comm.value();}
-      if (person_profile.has_value()) {interacting_person_.profile = person_profile.value();}
-      if (person_activities.has_value()) {
-        interacting_person_.activities = person_activities.value();
-      }
-      if (person_menu.has_value()) {interacting_person_.menu = person_menu.value();}
-      if (person_reminder.has_value()) {interacting_person_.reminder = person_reminder.value();}
+      updatePersonFromNode(interacting_person_, person_node.value());
+      markDirty(DirtyInput::PEOPLE);
     }
   }
   // Check if the person is around the robot:  person ---(is_with)---> robot
@@ -565,175 +725,94 @@ void AdaptationAgent::edge_created(
     if (person_node.has_value() && person_node.value().type() == "person" &&
       robot_node.has_value() && robot_node.value().name() == robot_name_)
     {
-      // Get the attributes of the person node
+      // Add the person to the list if it is not already there and update it
       auto person_name = G_->get_attrib_by_name<identifier_att>(person_node.value());
-      auto person_comm = G_->get_attrib_by_name<comm_parameters_att>(person_node.value());
-      auto person_profile = G_->get_attrib_by_name<skills_parameters_att>(person_node.value());
-      auto person_activities = G_->get_attrib_by_name<activities_att>(person_node.value());
-      auto person_menu = G_->get_attrib_by_name<menu1_att>(person_node.value());
-      auto person_neuron = G_->get_attrib_by_name<neuron_att>(person_node.value());
-      // Updates person with robot attribute
-      personData current_person;
-      if (person_name.has_value()) {current_person.identifier = person_name.value();}
-      if (person_comm.has_value()) {current_person.commParameters = person_comm.value();}
-      if (person_profile.has_value()) {current_person.profile = person_profile.value();}
-      if (person_activities.has_value()) {current_person.activities = person_activities.value();}
-      if (person_menu.has_value()) {current_person.menu = person_menu.value();}
-      if (person_neuron.has_value()) {current_person.neuron = person_neuron.value();}
-      // Check if the person is already in the list
-      auto it = std::find_if(
-        people_with_robot_.begin(), people_with_robot_.end(),
-        [current_person](const auto & person) {
-          return person.identifier == current_person.identifier;
-        });
-      // Add the person to the list if it is not already there
+      auto & current_person = people_with_robot_.insert(from, person_name.value_or(""));
+      updatePersonFromNode(current_person, person_node.value());
       logger_->info(
         "Person created with {} and menu: {}", current_person.identifier, current_person.menu);
-      if (it == people_with_robot_.end()) {
-        people_with_robot_.push_back(current_person);
-      }
+      markDirty(DirtyInput::PEOPLE);
+    }
+  }
+  // Check if a button has been pushed: robot ---(wants_to)---> bring_water/tracking/explanation
+  else if (type == "wants_to") {
+    auto to_node = G_->get_node(to);
+    if (to_node.has_value() && isButtonNode(to_node.value().name())) {
+      setButtonPresent(to_node.value().name(), true);
+      markDirty(DirtyInput::BUTTONS);
     }
   }
 }
 
-// Preference Learning methods
+// Person data
 // ----------------------------------------------------------------------------
 
-bool AdaptationAgent::priorityUseCase(UseCase & use_case)
+void AdaptationAgent::updatePersonFromNode(personData & person, const DSR::Node & node)
 {
-  bool success = false;
-  float battery = 50.0;
-
-  if (auto battery_node = G_->get_node("battery"); battery_node.has_value()) {
-    auto battery_level = G_->get_attrib_by_name<battery_percentage_att>(battery_node.value());
-    battery = battery_level.value();
-  } else {
-    //logger_->error("Battery node not found. Using default value: 50.0");
+  for (const auto & [att_name, field] : kPersonAttributes) {
+    updatePersonField(person, node, field);
   }
-
-  if (battery < 10.0) {
-    use_case = UseCase::CHARGING;
-    success = true;
-  }
-
-  return success;
+  person.version++;
 }
 
-bool AdaptationAgent::plannedGroupUseCase(UseCase & use_case)
+bool AdaptationAgent::updatePersonFromNode(
+  personData & person, const DSR::Node & node, const std::vector<std::string> & att_names)
 {
-  bool terapia_musical = findActivityInAgenda("Terapia Musical", 0);
-  if (terapia_musical) {
-    use_case = UseCase::MUSIC;
-    logger_->info("Terapia musical activada");
+  bool updated = false;
+  for (const auto & att_name : att_names) {
+    if (auto it = kPersonAttributes.find(att_name); it != kPersonAttributes.end()) {
+      updatePersonField(person, node, it->second);
+      updated = true;
+    }
   }
-  return terapia_musical;
-}
-
-bool AdaptationAgent::buttonPushedUseCase(UseCase & use_case)
-{
-  bool success = false;
-  if (auto water_node = G_->get_node("bring_water"); water_node.has_value()) {
-    use_case = UseCase::GETME;
-    success = true;
-  } else if (auto tracking_node = G_->get_node("tracking"); tracking_node.has_value()) {
-    use_case = UseCase::ANNOUNCER;
-    success = true;
-  } else if (auto explanation_node = G_->get_node("explanation"); explanation_node.has_value()) {
-    use_case = UseCase::EXPLANATION;
-    success = true;
-  }
-  return success;
-}
-
-UseCase AdaptationAgent::selectedUseCaseForUser(int user)
-{
-  std::vector<int64_t> enviroment_data_aux = updateInputDataUser(user);
-  auto priorities = pref_learning_->getPriorities(enviroment_data_aux);
-  if (priorities.front() == UseCase::GETME) {             //CUTRE
-    priorities.front() = UseCase::WANDERING;
+  if (updated) {
+    person.version++;
   }
-  // We do the +1 because the preference learning doesn't have the DO_NOTHING use case
-  return UseCase(priorities.front());
+  return updated;
 }
 
-int AdaptationAgent::evaluate(UseCase use_case)
+void AdaptationAgent::updatePersonField(
+  personData & person, const DSR::Node & node, PersonField field)
 {
-  int result = 0;
-  if (use_case == UseCase::REMINDER) {
-    result = 3;
-  } else if (use_case == UseCase::NEURON_UP) {
-    result = 2;
-  } else if (use_case == UseCase::MENU) {
-    result = 1;
-  }
-  return result;
-}
-
-bool AdaptationAgent::findActivityInAgenda(std::string activity_name, int pretime)
-{
-  bool activity = false;
-  auto activity_list = getActivityfromJstring(robot_agenda_);
-  std::string hour = currentTime(pretime);
-
-  // Find the activity in the list
-  auto it = std::find_if(
-    activity_list.begin(), activity_list.end(), [&](const auto & act) {
-      return act.nombre == activity_name;
-    });
-  // If the activities attribute has changed,
-  if (it != activity_list.end()) {
-    int minutosActual = StringTimeToMinutes(hour);
-    int minutosInicioActividad = StringTimeToMinutes(it->hora_inicio);
-    int minutosFinalActividad = StringTimeToMinutes(it->hora_fin);
-    activity = (minutosActual >= minutosInicioActividad) && (minutosActual < minutosFinalActividad);
-    logger_->info("Activity {} found from {} to {}", it->nombre, it->hora_inicio, it->hora_fin);
-  }
-  return activity;
-}
-
-bool AdaptationAgent::isPersonBusy(personData person, int pretime)
-{
-  bool activity = false;
-  auto activity_list = getActivityfromJstring(person.activities);
-  std::string hour = currentTime(pretime);
-
-  logger_->info("Checking if a person {} is busy at {}", person.identifier, currentTime(pretime));
-
-  for (const auto & act : activity_list) {
-    int minutosActual = StringTimeToMinutes(hour);
-    int minutosInicioActividad = StringTimeToMinutes(act.hora_inicio);
-    int minutosFinalActividad = StringTimeToMinutes(act.hora_fin);
-    activity = (minutosActual >= minutosInicioActividad) && (minutosActual < minutosFinalActividad);
-    if (activity) {
-      logger_->info("Activity {} found from {} to {}", act.nombre, act.hora_inicio, act.hora_fin);
+  // The JSON attributes are parsed only here and not in each compute
+  switch (field) {
+    case PersonField::COMM_PARAMETERS:
+      if (auto comm = G_->get_attrib_by_name<comm_parameters_att>(node); comm.has_value()) {
+        person.commParameters = json::accept(comm.value()) ?
+          json::parse(comm.value()).get<CommParameters>() : CommParameters{};
+      }
+      break;
+    case PersonField::PROFILE:
+      if (auto profile = G_->get_attrib_by_name<skills_parameters_att>(node);
+        profile.has_value())
+      {
+        person.profile = json::accept(profile.value()) ?
+          json::parse(profile.value()).get<Profile>() : Profile{};
+      }
+      break;
+    case PersonField::ACTIVITIES:
+      if (auto activities = G_->get_attrib_by_name<activities_att>(node);
+        activities.has_value())
+      {
+        person.activities = parseAgenda(activities.value());
+      }
+      break;
+    case PersonField::MENU:
+      if (auto menu = G_->get_attrib_by_name<menu1_att>(node); menu.has_value()) {
+        person.menu = menu.value();
+      }
+      break;
+    case PersonField::NEURON:
+      if (auto neuron = G_->get_attrib_by_name<neuron_att>(node); neuron.has_value()) {
+        person.neuron = neuron.value();
+      }
+      break;
+    case PersonField::REMINDER:
+      if (auto reminder = G_->get_attrib_by_name<reminder_att>(node); reminder.has_value()) {
+        person.reminder = reminder.value();
+      }
       break;
-    }
   }
-
-  return activity;
-}
-
-std::vector<int64_t> AdaptationAgent::updateInputDataUser(int user_id)
-{
-  std::vector<int64_t> enviroment_d_user = {0, 0, 0, 0};
-  if (!people_with_robot_.empty()) {
-    logger_->info("Updating input data for user: {}", user_id);
-
-    // Menu
-    enviroment_d_user[0] = people_with_robot_[user_id].menu.empty() ? 0 : 1;
-    // Interaction
-    enviroment_d_user[1] = 1;
-    // Busy
-    enviroment_d_user[2] =
-      (isPersonBusy(
-        people_with_robot_[user_id],
-        15) && people_with_robot_[user_id].reminder ) ? 1 : 0;
-    // Cognitive
-    enviroment_d_user[3] =
-      (findActivityInAgenda("Terapia Cognitiva", 0) &&
-      (people_with_robot_[user_id].neuron)) ? 1 : 0;
-  }
-  return enviroment_d_user;
 }
 
 // Helpers
@@ -744,6 +823,16 @@ int AdaptationAgent::StringTimeToMinutes(std::string hour)
   return (std::stoi(hour.substr(0, 2)) * 60) + std::stoi(hour.substr(3, 5));
 }
 
+std::vector<agendaActivity> AdaptationAgent::parseAgenda(const std::string & agenda)
+{
+  std::vector<agendaActivity> activities;
+  for (const auto & act : getActivityfromJstring(agenda)) {
+    activities.push_back(
+      {act.nombre, StringTimeToMinutes(act.hora_inicio), StringTimeToMinutes(act.hora_fin)});
+  }
+  return activities;
+}
+
 UseCase AdaptationAgent::fromStr(std::string use_case_str)
 {
   if (use_case_str == "wandering") {
@@ -769,47 +858,6 @@ UseCase AdaptationAgent::fromStr(std::string use_case_str)
   }
 }
 
-std::string AdaptationAgent::toStr(UseCase use_case)
-{
-  if (use_case == UseCase::WANDERING) {
-    return "wandering";
-  } else if (use_case == UseCase::CHARGING) {
-    return "charging";
-  } else if (use_case == UseCase::MENU) {
-    return "menu";
-  } else if (use_case == UseCase::MUSIC) {
-    return "music";
-  } else if (use_case == UseCase::NEURON_UP) {
-    return "neuron";
-  } else if (use_case == UseCase::GETME) {
-    return "water";
-  } else if (use_case == UseCase::REMINDER) {
-    return "reminder";
-  } else if (use_case == UseCase::ANNOUNCER) {
-    return "tracking";
-  } else if (use_case == UseCase::EXPLANATION) {
-    return "explanation";
-  } else {
-    return "do_nothing";
-  }
-}
-
-std::string AdaptationAgent::currentTime(int premin)
-{
-  time_t current_time;
-  struct tm * now_tm;
-  time(&current_time);
-  current_time += 60 * premin;
-  now_tm = localtime(&current_time);
-
-  std::stringstream ss;
-  ss <<
-    (now_tm->tm_hour <
-  10 ? "0" : "") << now_tm->tm_hour << ":" << (now_tm->tm_min < 10 ? "0" : "") << now_tm->tm_min;
-
-  return ss.str();
-}
-
 bool AdaptationAgent::notWaitUseCase(UseCase prior)
 {
   return (prior == UseCase::WANDERING) || (prior == UseCase::DO_NOTHING) ||
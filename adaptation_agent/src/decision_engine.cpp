@@ -0,0 +1,315 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "adaptationAgent/decision_engine.hpp"
+#include "adaptationAgent/minute_clock.hpp"
+
+DecisionEngine::DecisionEngine(
+  std::unique_ptr<PreferenceLearning> pref_learning, float battery_low,
+  float battery_recovered, DecisionTrace * trace, spdlog::logger * logger,
+  std::function<void(const decisionResult &)> on_decision)
+: pref_learning_(std::move(pref_learning)), battery_low_(battery_low),
+  battery_recovered_(battery_recovered), charging_(false), trace_(trace), logger_(logger),
+  on_decision_(on_decision), pending_(false), running_(true)
+{
+  thread_ = std::thread(&DecisionEngine::run, this);
+}
+
+DecisionEngine::~DecisionEngine()
+{
+  running_ = false;
+  pending_ = true;
+  pending_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void DecisionEngine::publish(std::shared_ptr<const decisionInputs> inputs)
+{
+  {
+    std::lock_guard<std::mutex> lock(inputs_mutex_);
+    inputs_.swap(inputs);
+  }
+  pending_ = true;
+  pending_.notify_one();
+}
+
+void DecisionEngine::run()
+{
+  while (running_) {
+    pending_.wait(false);
+    pending_ = false;
+    // Only the latest inputs are evaluated
+    std::shared_ptr<const decisionInputs> inputs;
+    {
+      std::lock_guard<std::mutex> lock(inputs_mutex_);
+      inputs.swap(inputs_);
+    }
+    if (!running_ || !inputs) {
+      continue;
+    }
+
+    auto decision_start = std::chrono::steady_clock::now();
+    decisionRecord record{};
+    auto result = decide(*inputs, record);
+    auto latency = std::chrono::steady_clock::now() - decision_start;
+    decision_latency_.record(latency);
+    on_decision_(result);
+
+    record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+    record.latency = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+    trace_->write(record);
+
+    if (decision_latency_.count() >= kLatencyReportPeriod) {
+      reportLatencies();
+    }
+  }
+}
+
+decisionResult DecisionEngine::decide(const decisionInputs & inputs, decisionRecord & record)
+{
+  decisionResult result{inputs.sequence, std::nullopt, "", DecisionRule::INTERACTING};
+  UseCase selected_use_case = UseCase::DO_NOTHING;
+  record.sequence = inputs.sequence;
+  record.minute = static_cast<int16_t>(inputs.minute);
+  record.battery_level = inputs.battery_level;
+  record.rule = DecisionRule::INTERACTING;
+
+  // Execute preference learning
+  if (!priorityUseCase(inputs, selected_use_case)) {
+    if (!plannedGroupUseCase(inputs, selected_use_case)) {
+      // Sólo habilitado con wandering, no quita el recargar o el terapia.
+      if (!buttonPushedUseCase(inputs, selected_use_case)) {
+        // There isn't a person interacting with the robot
+        if (!inputs.person_interacting) {
+          // Elegimos persona y caso de uso
+          std::vector<int> value_use_cases;
+          std::vector<UseCase> use_cases;
+          record.rule = DecisionRule::USER;
+          record.num_users = static_cast<uint8_t>(std::min<std::size_t>(inputs.people.size(), 255));
+          for (const auto & person : inputs.people) {
+            const auto & decision = decisionForUser(inputs, person);
+            // The votes of the users are only formatted when the trace is dumped
+            if (use_cases.size() < kMaxTraceUsers) {
+              auto & user = record.users[use_cases.size()];
+              person.identifier.copy(user.identifier, sizeof(user.identifier));
+              for (std::size_t i = 0; i < std::size(user.inputs) && i < decision.inputs.size();
+                ++i)
+              {
+                user.inputs[i] = static_cast<int8_t>(decision.inputs[i]);
+              }
+              user.use_case = static_cast<uint8_t>(decision.use_case);
+              user.score = static_cast<int8_t>(decision.score);
+            }
+            use_cases.push_back(decision.use_case);
+            value_use_cases.push_back(decision.score);
+          }
+          if (use_cases.size() == 0) {
+            selected_use_case = UseCase::WANDERING;
+          } else {
+            auto max_iter = std::max_element(value_use_cases.begin(), value_use_cases.end());
+            int max_index = std::distance(value_use_cases.begin(), max_iter);
+            selected_use_case = use_cases.at(max_index);
+            result.person = inputs.people.at(max_index).identifier;
+          }
+          result.use_case = selected_use_case;
+        }
+      } else {
+        result.use_case = selected_use_case;
+        record.rule = DecisionRule::BUTTON;
+      }
+    } else {
+      result.use_case = selected_use_case;
+      record.rule = DecisionRule::GROUP;
+    }
+  } else {
+    result.use_case = selected_use_case;
+    record.rule = DecisionRule::PRIORITY;
+  }
+  record.use_case = static_cast<uint8_t>(result.use_case.value_or(UseCase::DO_NOTHING));
+  result.rule = record.rule;
+
+  // Forget the people that are not with the robot anymore
+  std::erase_if(
+    decisions_, [&inputs](const auto & decision) {
+      return std::none_of(
+        inputs.people.begin(), inputs.people.end(), [&decision](const auto & person) {
+          return person.identifier == decision.first;
+        });
+    });
+  return result;
+}
+
+bool DecisionEngine::priorityUseCase(const decisionInputs & inputs, UseCase & use_case)
+{
+  if (inputs.battery_level < battery_low_) {
+    charging_ = true;
+  } else if (inputs.battery_level >= battery_recovered_) {
+    charging_ = false;
+  }
+
+  if (charging_) {
+    use_case = UseCase::CHARGING;
+  }
+  return charging_;
+}
+
+bool DecisionEngine::plannedGroupUseCase(const decisionInputs & inputs, UseCase & use_case)
+{
+  bool terapia_musical = findActivityInAgenda(inputs, "Terapia Musical", 0);
+  if (terapia_musical) {
+    use_case = UseCase::MUSIC;
+  }
+  return terapia_musical;
+}
+
+bool DecisionEngine::buttonPushedUseCase(const decisionInputs & inputs, UseCase & use_case)
+{
+  bool success = false;
+  if (inputs.bring_water_present) {
+    use_case = UseCase::GETME;
+    success = true;
+  } else if (inputs.tracking_present) {
+    use_case = UseCase::ANNOUNCER;
+    success = true;
+  } else if (inputs.explanation_present) {
+    use_case = UseCase::EXPLANATION;
+    success = true;
+  }
+  return success;
+}
+
+UseCase DecisionEngine::selectedUseCaseForUser(const std::vector<int64_t> & user_inputs)
+{
+  auto priorities = pref_learning_->getPriorities(user_inputs);
+  if (priorities.front() == UseCase::GETME) {             //CUTRE
+    priorities.front() = UseCase::WANDERING;
+  }
+  // We do the +1 because the preference learning doesn't have the DO_NOTHING use case
+  return UseCase(priorities.front());
+}
+
+const userDecision & DecisionEngine::decisionForUser(
+  const decisionInputs & inputs, const personData & person)
+{
+  // Reuse the last decision if nothing it depends on has changed
+  auto it = decisions_.find(person.identifier);
+  if (it == decisions_.end() || it->second.person_version != person.version ||
+    it->second.agenda_version != inputs.robot_agenda_version || it->second.minute != inputs.minute)
+  {
+    auto user_inputs = updateInputDataUser(inputs, person);
+    UseCase use_case = selectedUseCaseForUser(user_inputs);
+    it = decisions_.insert_or_assign(
+      person.identifier, userDecision{
+        person.version, inputs.robot_agenda_version, inputs.minute, use_case,
+        evaluate(use_case), std::move(user_inputs)}).first;
+  }
+  return it->second;
+}
+
+int DecisionEngine::evaluate(UseCase use_case)
+{
+  int result = 0;
+  if (use_case == UseCase::REMINDER) {
+    result = 3;
+  } else if (use_case == UseCase::NEURON_UP) {
+    result = 2;
+  } else if (use_case == UseCase::MENU) {
+    result = 1;
+  }
+  return result;
+}
+
+bool DecisionEngine::findActivityInAgenda(
+  const decisionInputs & inputs, const std::string & activity_name, int pretime)
+{
+  bool activity = false;
+  int minute = (inputs.minute + pretime) % MinuteClock::kMinutesPerDay;
+
+  // Find the activity in the list
+  auto it = std::find_if(
+    inputs.robot_activities.begin(), inputs.robot_activities.end(), [&](const auto & act) {
+      return act.name == activity_name;
+    });
+  // If the activities attribute has changed,
+  if (it != inputs.robot_activities.end()) {
+    activity = (minute >= it->start_minute) && (minute < it->end_minute);
+    logger_->debug(
+      "Activity {} found from {:02}:{:02} to {:02}:{:02}", it->name, it->start_minute / 60,
+      it->start_minute % 60, it->end_minute / 60, it->end_minute % 60);
+  }
+  return activity;
+}
+
+bool DecisionEngine::isPersonBusy(
+  const decisionInputs & inputs, const personData & person, int pretime)
+{
+  bool activity = false;
+  int minute = (inputs.minute + pretime) % MinuteClock::kMinutesPerDay;
+
+  logger_->debug(
+    "Checking if a person {} is busy at {:02}:{:02}", person.identifier, minute / 60,
+    minute % 60);
+
+  for (const auto & act : person.activities) {
+    activity = (minute >= act.start_minute) && (minute < act.end_minute);
+    if (activity) {
+      logger_->debug(
+        "Activity {} found from {:02}:{:02} to {:02}:{:02}", act.name, act.start_minute / 60,
+        act.start_minute % 60, act.end_minute / 60, act.end_minute % 60);
+      break;
+    }
+  }
+
+  return activity;
+}
+
+std::vector<int64_t> DecisionEngine::updateInputDataUser(
+  const decisionInputs & inputs, const personData & person)
+{
+  std::vector<int64_t> enviroment_d_user = {0, 0, 0, 0};
+  logger_->debug("Updating input data for user: {}", person.identifier);
+
+  // Menu
+  enviroment_d_user[0] = person.menu.empty() ? 0 : 1;
+  // Interaction
+  enviroment_d_user[1] = 1;
+  // Busy
+  enviroment_d_user[2] =
+    (isPersonBusy(inputs, person, kBusyPretime) && person.reminder) ? 1 : 0;
+  // Cognitive
+  enviroment_d_user[3] =
+    (findActivityInAgenda(inputs, "Terapia Cognitiva", 0) && person.neuron) ? 1 : 0;
+  return enviroment_d_user;
+}
+
+void DecisionEngine::reportLatencies()
+{
+  logger_->info("Compute latency: {}", decision_latency_.summary());
+  logger_->info("Decision latency: {}", pref_learning_->getDecisionLatency().summary());
+  const auto & model_names = pref_learning_->getModelNames();
+  for (std::size_t i = 0; i < model_names.size(); ++i) {
+    logger_->info(
+      "Model {} latency: {}", model_names[i], pref_learning_->getModelLatency(i).summary());
+  }
+  decision_latency_.reset();
+  pref_learning_->resetLatencies();
+}
@@ -0,0 +1,149 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "adaptationAgent/decision_trace.hpp"
+#include "adaptationAgent/types.hpp"
+
+DecisionTrace::DecisionTrace()
+: head_(0), next_read_(0), running_(false)
+{
+}
+
+DecisionTrace::~DecisionTrace()
+{
+  running_ = false;
+  if (dumper_.joinable()) {
+    dumper_started_ = false;
+    sem_post(&dump_semaphore_);
+    dumper_.join();
+    sem_destroy(&dump_semaphore_);
+  }
+}
+
+void DecisionTrace::write(const decisionRecord & record)
+{
+  uint64_t position = head_.load(std::memory_order_relaxed);
+  auto & slot = slots_[position % kCapacity];
+  std::array<uint64_t, kRecordWords> words{};
+  std::memcpy(words.data(), &record, sizeof(record));
+  // A reader that sees a new word also sees the odd sequence
+  slot.sequence.store(2 * position + 1, std::memory_order_relaxed);
+  for (std::size_t i = 0; i < kRecordWords; ++i) {
+    slot.words[i].store(words[i], std::memory_order_release);
+  }
+  slot.sequence.store(2 * position + 2, std::memory_order_release);
+  head_.store(position + 1, std::memory_order_release);
+}
+
+std::vector<decisionRecord> DecisionTrace::read()
+{
+  std::vector<decisionRecord> records;
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t first = std::max(next_read_, head > kCapacity ? head - kCapacity : 0);
+  for (uint64_t position = first; position < head; ++position) {
+    const auto & slot = slots_[position % kCapacity];
+    // Skip the records overwritten while they are copied
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * position + 2) {
+      continue;
+    }
+    std::array<uint64_t, kRecordWords> words;
+    for (std::size_t i = 0; i < kRecordWords; ++i) {
+      words[i] = slot.words[i].load(std::memory_order_acquire);
+    }
+    if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+      decisionRecord record;
+      std::memcpy(&record, words.data(), sizeof(record));
+      records.push_back(record);
+    }
+  }
+  next_read_ = head;
+  return records;
+}
+
+void DecisionTrace::startDumper(spdlog::logger * logger)
+{
+  if (running_.exchange(true)) {
+    return;
+  }
+  sem_init(&dump_semaphore_, 0, 0);
+  dumper_started_ = true;
+  dumper_ = std::thread(
+    [this, logger]() {
+      // The thread sleeps until a dump is requested or the trace is destroyed
+      while (sem_wait(&dump_semaphore_) == 0 || errno == EINTR) {
+        if (!running_) {
+          break;
+        }
+        if (dump_requested_.exchange(false)) {
+          dump(logger);
+        }
+      }
+    });
+}
+
+void DecisionTrace::requestDump()
+{
+  dump_requested_ = true;
+  if (dumper_started_) {
+    sem_post(&dump_semaphore_);
+  }
+}
+
+std::string DecisionTrace::decode(const decisionRecord & record)
+{
+  static constexpr const char * kRuleNames[] = {
+    "priority", "group", "button", "user", "interacting"};
+  std::time_t seconds = record.timestamp / 1000000000;
+  std::tm local_time{};
+  localtime_r(&seconds, &local_time);
+
+  std::string line = fmt::format(
+    "Decision {} at {:02}:{:02}:{:02}.{:03} ({:02}:{:02} in the agenda, battery {:.1f}%): "
+    "{} -> {} in {} us", record.sequence, local_time.tm_hour, local_time.tm_min,
+    local_time.tm_sec, record.timestamp / 1000000 % 1000, record.minute / 60,
+    record.minute % 60, record.battery_level,
+    kRuleNames[static_cast<uint8_t>(record.rule)], toStr(UseCase(record.use_case)),
+    record.latency / 1000);
+  auto num_users = std::min<std::size_t>(record.num_users, kMaxTraceUsers);
+  for (std::size_t i = 0; i < num_users; ++i) {
+    const auto & user = record.users[i];
+    line += fmt::format(
+      "; {} [{} {} {} {}] votes {} with score {}",
+      std::string(user.identifier, strnlen(user.identifier, sizeof(user.identifier))),
+      user.inputs[0], user.inputs[1], user.inputs[2], user.inputs[3],
+      toStr(UseCase(user.use_case)), user.score);
+  }
+  if (record.num_users > num_users) {
+    line += fmt::format("; and {} users more", record.num_users - num_users);
+  }
+  return line;
+}
+
+void DecisionTrace::dump(spdlog::logger * logger)
+{
+  auto records = read();
+  logger->info("Dumping the last {} decisions", records.size());
+  for (const auto & record : records) {
+    logger->info(decode(record));
+  }
+}
@@ -13,9 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <charconv>
+#include <csignal>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <optional>
 #include <string>
 #include <thread>
 
@@ -61,6 +64,27 @@ std::map<std::string, std::string> parseConfig(const std::string & configFilePat
   return configParams;
 }
 
+// Parse a time of the day in the HH:MM format to the minute of the day
+std::optional<int> parseMinuteOfDay(const std::string & time)
+{
+  int hours = 0;
+  int minutes = 0;
+  if (time.size() != 5 || time[2] != ':') {
+    return std::nullopt;
+  }
+  auto hours_end = time.data() + 2;
+  auto minutes_end = time.data() + 5;
+  auto [hours_ptr, hours_error] = std::from_chars(time.data(), hours_end, hours);
+  auto [minutes_ptr, minutes_error] = std::from_chars(time.data() + 3, minutes_end, minutes);
+  if (hours_error != std::errc() || hours_ptr != hours_end ||
+    minutes_error != std::errc() || minutes_ptr != minutes_end ||
+    hours < 0 || hours > 23 || minutes < 0 || minutes > 59)
+  {
+    return std::nullopt;
+  }
+  return hours * 60 + minutes;
+}
+
 int main(int argc, char * argv[])
 {
   QCoreApplication app(argc, argv);
@@ -78,6 +102,24 @@ int main(int argc, char * argv[])
   auto robot_name = config["robot_name"];
   auto log_path = config["log_path"];
   auto models = config["models"];
+  auto shadow_models = config["shadow_models"];
+  auto safety_period = config["safety_period"].empty() ? 5000 : std::stoi(config["safety_period"]);
+  auto simulation_speed =
+    config["simulation_speed"].empty() ? 1.0 : std::stod(config["simulation_speed"]);
+  auto simulation_start = config["simulation_start"];
+  switchingPolicy switching_policy;
+  if (!config["battery_low"].empty()) {
+    switching_policy.battery_low = std::stof(config["battery_low"]);
+  }
+  if (!config["battery_recovered"].empty()) {
+    switching_policy.battery_recovered = std::stof(config["battery_recovered"]);
+  }
+  if (!config["min_dwell"].empty()) {
+    switching_policy.min_dwell = std::stoi(config["min_dwell"]);
+  }
+  if (!config["debounce"].empty()) {
+    switching_policy.debounce = std::stoi(config["debounce"]);
+  }
 
   std::cout << "Configuration parameters for the adaptationAgent:" << std::endl;
   std::cout << "Agent name: " << agent_name << std::endl;
@@ -85,10 +127,36 @@ int main(int argc, char * argv[])
   std::cout << "Robot name: " << robot_name << std::endl;
   std::cout << "Log path: " << log_path << std::endl;
   std::cout << "Models: " << models << std::endl;
+  std::cout << "Shadow models: " << shadow_models << std::endl;
+  std::cout << "Safety period: " << safety_period << std::endl;
+  std::cout << "Simulation speed: " << simulation_speed << std::endl;
+  std::cout << "Simulation start: " << simulation_start << std::endl;
+  std::cout << "Battery low: " << switching_policy.battery_low << std::endl;
+  std::cout << "Battery recovered: " << switching_policy.battery_recovered << std::endl;
+  std::cout << "Minimum dwell: " << switching_policy.min_dwell << std::endl;
+  std::cout << "Debounce: " << switching_policy.debounce << std::endl;
 
   auto adaptation_agent = AdaptationAgent(agent_name, agent_id, robot_name);
-  adaptation_agent.initializeLogger(log_path);
-  adaptation_agent.initializeAdaptation(models);
+  adaptation_agent.initializeLogger(log_path, loggerParametersFromConfig(config));
+  // Replace the system time by a simulated one starting at the given time
+  if (simulation_speed != 1.0 || !simulation_start.empty()) {
+    int start_minute = SystemMinuteClock().minuteOfDay();
+    if (!simulation_start.empty()) {
+      auto minute = parseMinuteOfDay(simulation_start);
+      if (!minute.has_value()) {
+        std::cerr << "Invalid simulation start '" << simulation_start << "', expected HH:MM" <<
+          std::endl;
+        return 1;
+      }
+      start_minute = minute.value();
+    }
+    adaptation_agent.setClock(
+      std::make_unique<SimulatedMinuteClock>(start_minute, simulation_speed));
+  }
+  adaptation_agent.setSwitchingPolicy(switching_policy);
+  adaptation_agent.initializeAdaptation(models, shadow_models, safety_period);
+  // Dump the last decisions to the explicability log with 'kill -USR1 <pid>'
+  std::signal(SIGUSR1, [](int) {DecisionTrace::requestDump();});
 
   return app.exec();
 }
@@ -0,0 +1,67 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <utility>
+
+#include "adaptationAgent/person_store.hpp"
+
+personData * PersonStore::find(uint64_t node_id)
+{
+  auto it = people_.find(node_id);
+  return it != people_.end() ? &it->second : nullptr;
+}
+
+personData * PersonStore::find(const std::string & identifier)
+{
+  auto it = by_identifier_.find(identifier);
+  return it != by_identifier_.end() ? find(it->second) : nullptr;
+}
+
+personData & PersonStore::insert(uint64_t node_id, const std::string & identifier)
+{
+  if (auto it = people_.find(node_id); it != people_.end()) {
+    // The identifier of the node has changed
+    if (it->second.identifier != identifier) {
+      by_identifier_.erase(it->second.identifier);
+      by_identifier_[identifier] = node_id;
+      it->second.identifier = identifier;
+      it->second.version++;
+    }
+    return it->second;
+  }
+
+  personData person;
+  // The same person with a new node keeps its data
+  if (auto it = by_identifier_.find(identifier); it != by_identifier_.end()) {
+    person = std::move(people_.at(it->second));
+    people_.erase(it->second);
+    person.version++;
+  }
+  person.identifier = identifier;
+  by_identifier_[identifier] = node_id;
+  return people_.emplace(node_id, std::move(person)).first->second;
+}
+
+bool PersonStore::erase(uint64_t node_id)
+{
+  auto it = people_.find(node_id);
+  if (it == people_.end()) {
+    return false;
+  }
+  by_identifier_.erase(it->second.identifier);
+  people_.erase(it);
+  return true;
+}
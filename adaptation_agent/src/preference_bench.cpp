@@ -0,0 +1,153 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "adaptationAgent/preference_learning.hpp"
+
+// Number of features of the input vector used by the adaptation agent
+constexpr std::size_t kNumInputs = 4;
+
+// Microseconds of a duration, with decimals
+double toMicroseconds(std::chrono::nanoseconds duration)
+{
+  return static_cast<double>(duration.count()) / 1000.0;
+}
+
+// All the combinations of binary features
+std::vector<std::vector<int64_t>> exhaustiveInputs()
+{
+  std::vector<std::vector<int64_t>> inputs;
+  for (std::size_t mask = 0; mask < (1u << kNumInputs); ++mask) {
+    std::vector<int64_t> input(kNumInputs);
+    for (std::size_t i = 0; i < kNumInputs; ++i) {
+      input[i] = (mask >> i) & 1;
+    }
+    inputs.push_back(input);
+  }
+  return inputs;
+}
+
+// Random binary features
+std::vector<std::vector<int64_t>> randomInputs(std::size_t size)
+{
+  std::mt19937 mt(42);
+  std::bernoulli_distribution dist(0.5);
+  std::vector<std::vector<int64_t>> inputs(size, std::vector<int64_t>(kNumInputs));
+  for (auto & input : inputs) {
+    for (auto & value : input) {
+      value = dist(mt) ? 1 : 0;
+    }
+  }
+  return inputs;
+}
+
+int main(int argc, char * argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] <<
+      " <models_folder> [exhaustive|random] [iterations] [batch_size]" << std::endl;
+    return 1;
+  }
+
+  std::string models = argv[1];
+  std::string mode = argc > 2 ? argv[2] : "exhaustive";
+  std::size_t iterations = argc > 3 ? std::stoul(argv[3]) : 10000;
+  std::size_t batch_size = argc > 4 ? std::stoul(argv[4]) : 16;
+  if (mode != "exhaustive" && mode != "random") {
+    std::cerr << "Unknown mode: " << mode << ". Use 'exhaustive' or 'random'" << std::endl;
+    return 1;
+  }
+  if (iterations == 0 || batch_size == 0) {
+    std::cerr << "The iterations and the batch size must be greater than 0" << std::endl;
+    return 1;
+  }
+
+  auto inputs = mode == "exhaustive" ? exhaustiveInputs() : randomInputs(iterations);
+
+  // Load the models
+  PreferenceLearning pref_learning;
+  auto load_start = std::chrono::steady_clock::now();
+  pref_learning.loadSessions(models);
+  auto load_time = std::chrono::steady_clock::now() - load_start;
+
+  const auto & model_names = pref_learning.getModelNames();
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "Loaded " << model_names.size() << " models in " <<
+    toMicroseconds(load_time) / 1000.0 << " ms" << std::endl;
+  for (std::size_t i = 0; i < model_names.size(); ++i) {
+    std::cout << "  " << model_names[i] << ": " <<
+      toMicroseconds(pref_learning.getLoadTime(i)) / 1000.0 << " ms" << std::endl;
+  }
+
+  // Warm up the sessions
+  for (const auto & input : inputs) {
+    pref_learning.getPriorities(input);
+  }
+  pref_learning.resetLatencies();
+
+  // Single calls
+  auto single_start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i) {
+    pref_learning.getPriorities(inputs[i % inputs.size()]);
+  }
+  auto single_time = std::chrono::steady_clock::now() - single_start;
+
+  std::cout << std::endl << "Single calls (" << mode << ", " << iterations << " decisions)" <<
+    std::endl;
+  for (std::size_t i = 0; i < model_names.size(); ++i) {
+    const auto & latency = pref_learning.getModelLatency(i);
+    std::cout << "  " << model_names[i] << ": p50 " << toMicroseconds(latency.percentile(50)) <<
+      " us, p99 " << toMicroseconds(latency.percentile(99)) << " us" << std::endl;
+  }
+  const auto & decision = pref_learning.getDecisionLatency();
+  std::cout << "  Decision: p50 " << toMicroseconds(decision.percentile(50)) << " us, p99 " <<
+    toMicroseconds(decision.percentile(99)) << " us, max " << toMicroseconds(decision.max()) <<
+    " us" << std::endl;
+  std::cout << "  Throughput: " <<
+    iterations / std::chrono::duration<double>(single_time).count() << " decisions/s" <<
+    std::endl;
+
+  // Batched calls
+  std::vector<std::vector<int64_t>> batch;
+  for (std::size_t i = 0; i < batch_size; ++i) {
+    batch.push_back(inputs[i % inputs.size()]);
+  }
+  std::size_t num_batches = std::max<std::size_t>(iterations / batch_size, 1);
+  LatencyHistogram batch_latency;
+  auto batch_start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < num_batches; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    pref_learning.getPrioritiesBatch(batch);
+    batch_latency.record(std::chrono::steady_clock::now() - start);
+  }
+  auto batch_time = std::chrono::steady_clock::now() - batch_start;
+
+  std::cout << std::endl << "Batched calls (" << num_batches << " batches of " << batch_size <<
+    ")" << std::endl;
+  std::cout << "  Batch: p50 " << toMicroseconds(batch_latency.percentile(50)) << " us, p99 " <<
+    toMicroseconds(batch_latency.percentile(99)) << " us" << std::endl;
+  std::cout << "  Throughput: " <<
+    num_batches * batch_size / std::chrono::duration<double>(batch_time).count() <<
+    " decisions/s" << std::endl;
+
+  return 0;
+}
@@ -14,6 +14,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <filesystem>
 #include <map>
@@ -21,11 +23,16 @@
 #include <vector>
 
 #include "adaptationAgent/preference_learning.hpp"
+#include "adaptationAgent/shadow_evaluator.hpp"
 
 PreferenceLearning::PreferenceLearning()
 {
 }
 
+PreferenceLearning::~PreferenceLearning()
+{
+}
+
 void PreferenceLearning::loadSessions(std::string folderpath)
 {
   env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "test");
@@ -38,8 +45,17 @@ void PreferenceLearning::loadSessions(std::string folderpath)
   // Create the sessions
   for (const auto & modelName : model_names_) {
     //Ort::Session session(env, model_path.c_str(), session_options);
+    auto start = std::chrono::steady_clock::now();
     sessions_.push_back(Ort::Session(env_, (folderpath + modelName).c_str(), session_options));
+    load_times_.push_back(std::chrono::steady_clock::now() - start);
   }
+  model_latencies_.resize(sessions_.size());
+}
+
+void PreferenceLearning::loadShadowSessions(
+  std::string folderpath, std::shared_ptr<spdlog::logger> logger)
+{
+  shadow_ = std::make_unique<ShadowEvaluator>(folderpath, logger);
 }
 
 void PreferenceLearning::loadModelsFiles(std::string folderpath)
@@ -72,7 +88,8 @@ std::string PreferenceLearning::getStringUseCase(std::string filename, int label
   return substr;
 }
 
-int64_t PreferenceLearning::evaluate(Ort::Session * session, std::vector<int64_t> input_data)
+std::vector<int64_t> PreferenceLearning::evaluate(
+  Ort::Session * session, std::vector<int64_t> & input_data, int64_t batch_size)
 {
   // Get the input and output names
   std::vector<const char *> input_names;
@@ -82,8 +99,9 @@ int64_t PreferenceLearning::evaluate(Ort::Session * session, std::vector<int64_t
   output_names.push_back("output_label");
   output_names.push_back("output_probability");
 
-  // Define the shape of the input tensor [1, 6]
-  std::vector<int64_t> input_shape = {1, 4};
+  // Define the shape of the input tensor [batch_size, 4]
+  int64_t num_inputs = static_cast<int64_t>(input_data.size()) / batch_size;
+  std::vector<int64_t> input_shape = {batch_size, num_inputs};
 
   auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
   // Create an Ort::Value object to contain the input data
@@ -97,28 +115,44 @@ int64_t PreferenceLearning::evaluate(Ort::Session * session, std::vector<int64_t
     output_names.data(), output_names.size());
 
   auto output_data = output_tensors[0].GetTensorMutableData<int64_t>();
-  return output_data[0];
+  return std::vector<int64_t>(output_data, output_data + batch_size);
 }
 
-
-std::vector<UseCase> PreferenceLearning::getPriorities(std::vector<int64_t> input_data)
+std::vector<UseCase> PreferenceLearning::sortByVotes(const std::map<std::string, int> & votes)
 {
-  // Print the input data
-  /* std::cout << "Input data ";
-  for (size_t i = 0; i < input_data.size(); ++i) {
-    std::cout << input_data[i];
-    if (i != input_data.size() - 1) {
-      std::cout << " ";
+  // Copy the elements of the map to a vector of pairs (key, value)
+  std::vector<std::pair<std::string, int>> vec(votes.begin(), votes.end());
+
+  // Sort the vector according to the value of the integer in decreasing order
+  std::sort(
+    vec.begin(), vec.end(), [](const auto & a, const auto & b) {
+      return a.second > b.second;
+    });
+
+  // Print the sorted vector of priorities
+  std::vector<UseCase> priorities;
+  // std::cout << "Priorities:" << std::endl;
+  for (const auto & pair : vec) {
+    // std::cout << "(" << pair.first << ", " << pair.second << ")" << std::endl;
+    auto it = usecase_strings_.find(pair.first);
+    if (it != usecase_strings_.end()) {
+      priorities.push_back(it->second);
     }
   }
-  std::cout << std::endl;
-  */
+  return priorities;
+}
+
+std::vector<UseCase> PreferenceLearning::getPriorities(std::vector<int64_t> input_data)
+{
+  auto decision_start = std::chrono::steady_clock::now();
 
   // Create a map to store the name of the use case and the number of times it is selected
   std::map<std::string, int> name_to_id;
   for (size_t i = 0; i < sessions_.size(); ++i) {
+    auto model_start = std::chrono::steady_clock::now();
     auto output_data = evaluate(&(sessions_[i]), input_data);
-    std::string aux = getStringUseCase(model_names_[i], output_data);
+    model_latencies_[i].record(std::chrono::steady_clock::now() - model_start);
+    std::string aux = getStringUseCase(model_names_[i], output_data.front());
     name_to_id[aux]++;
   }
 
@@ -128,24 +162,61 @@ std::vector<UseCase> PreferenceLearning::getPriorities(std::vector<int64_t> inpu
      std::cout << pair.first << " -> " << pair.second << std::endl;
   }*/
 
-  // Copy the elements of the map to a vector of pairs (key, value)
-  std::vector<std::pair<std::string, int>> vec(name_to_id.begin(), name_to_id.end());
+  auto priorities = sortByVotes(name_to_id);
+  decision_latency_.record(std::chrono::steady_clock::now() - decision_start);
 
-  // Sort the vector according to the value of the integer in decreasing order
-  std::sort(
-    vec.begin(), vec.end(), [](const auto & a, const auto & b) {
-      return a.second > b.second;
-    });
+  // Send the same inputs to the candidate models. It never blocks
+  if (shadow_) {
+    shadow_->submit(input_data, priorities);
+  }
+  return priorities;
+}
 
-  // Print the sorted vector of priorities
-  std::vector<UseCase> priorities;
-  // std::cout << "Priorities:" << std::endl;
-  for (const auto & pair : vec) {
-    // std::cout << "(" << pair.first << ", " << pair.second << ")" << std::endl;
-    auto it = usecase_strings_.find(pair.first);
-    if (it != usecase_strings_.end()) {
-      priorities.push_back(it->second);
+std::vector<std::vector<UseCase>> PreferenceLearning::getPrioritiesBatch(
+  const std::vector<std::vector<int64_t>> & batch)
+{
+  std::vector<std::vector<UseCase>> batch_priorities;
+  if (batch.empty()) {
+    return batch_priorities;
+  }
+
+  // Store the batch row by row
+  std::vector<int64_t> input_data;
+  input_data.reserve(batch.size() * batch.front().size());
+  for (const auto & input : batch) {
+    input_data.insert(input_data.end(), input.begin(), input.end());
+  }
+
+  // Run each model once for the whole batch
+  int64_t batch_size = static_cast<int64_t>(batch.size());
+  std::vector<std::map<std::string, int>> name_to_id(batch.size());
+  for (size_t i = 0; i < sessions_.size(); ++i) {
+    auto output_data = evaluate(&(sessions_[i]), input_data, batch_size);
+    for (size_t j = 0; j < batch.size(); ++j) {
+      name_to_id[j][getStringUseCase(model_names_[i], output_data[j])]++;
     }
   }
-  return priorities;
-}
\ No newline at end of file
+
+  for (const auto & votes : name_to_id) {
+    batch_priorities.push_back(sortByVotes(votes));
+  }
+  return batch_priorities;
+}
+
+void PreferenceLearning::resetLatencies()
+{
+  for (auto & latency : model_latencies_) {
+    latency.reset();
+  }
+  decision_latency_.reset();
+}
+
+std::string PreferenceLearning::getStringFromUseCase(UseCase use_case)
+{
+  for (const auto & [code, value] : usecase_strings_) {
+    if (value == use_case) {
+      return code;
+    }
+  }
+  return "";
+}
@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "adaptationAgent/preference_learning.hpp"
+#include "adaptationAgent/shadow_evaluator.hpp"
+
+ShadowEvaluator::ShadowEvaluator(
+  const std::string & folderpath, std::shared_ptr<spdlog::logger> logger)
+: logger_(logger), pending_(false), running_(true), dropped_(0), reported_dropped_(0),
+  evaluated_(0), agreements_(0)
+{
+  shadow_models_ = std::make_unique<PreferenceLearning>();
+  shadow_models_->loadSessions(folderpath);
+  logger_->info("Shadow models loaded from {}", folderpath);
+  thread_ = std::thread(&ShadowEvaluator::run, this);
+}
+
+ShadowEvaluator::~ShadowEvaluator()
+{
+  running_ = false;
+  pending_ = true;
+  pending_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  logStatistics();
+}
+
+bool ShadowEvaluator::submit(
+  const std::vector<int64_t> & input_data, const std::vector<UseCase> & live_priorities)
+{
+  if (input_data.size() > kMaxInputs || live_priorities.empty()) {
+    return false;
+  }
+
+  Sample sample;
+  std::copy(input_data.begin(), input_data.end(), sample.input.begin());
+  sample.input_size = static_cast<uint8_t>(input_data.size());
+  sample.live_choice = live_priorities.front();
+  if (!queue_.try_push(sample)) {
+    dropped_++;
+    return false;
+  }
+  // Waking the thread doesn't wait for it
+  pending_ = true;
+  pending_.notify_one();
+  return true;
+}
+
+void ShadowEvaluator::logStatistics()
+{
+  double agreement = evaluated_ > 0 ? 100.0 * agreements_ / evaluated_ : 0.0;
+  uint64_t dropped = dropped_.load();
+  logger_->info(
+    "Shadow agreement: {}/{} ({:.1f}%), dropped samples: {}",
+    agreements_, evaluated_, agreement, dropped);
+  if (dropped > reported_dropped_) {
+    logger_->warn(
+      "{} samples dropped because the shadow queue was full", dropped - reported_dropped_);
+    reported_dropped_ = dropped;
+  }
+}
+
+void ShadowEvaluator::run()
+{
+  Sample sample;
+  while (running_) {
+    // Sleep until a sample is queued
+    if (!queue_.try_pop(sample)) {
+      pending_.wait(false);
+      pending_ = false;
+      continue;
+    }
+
+    std::vector<int64_t> input(sample.input.begin(), sample.input.begin() + sample.input_size);
+    auto shadow_priorities = shadow_models_->getPriorities(input);
+    evaluated_++;
+
+    // Compare the use case selected by the live models with the candidate one
+    if (!shadow_priorities.empty() && shadow_priorities.front() == sample.live_choice) {
+      agreements_++;
+    } else {
+      std::string input_str;
+      for (const auto & value : input) {
+        input_str += (input_str.empty() ? "" : " ") + std::to_string(value);
+      }
+      logger_->info(
+        "Divergent case with input [{}]: live {} / shadow {}", input_str,
+        PreferenceLearning::getStringFromUseCase(sample.live_choice),
+        shadow_priorities.empty() ? "none" :
+        PreferenceLearning::getStringFromUseCase(shadow_priorities.front()));
+    }
+
+    if (evaluated_ % kStatisticsPeriod == 0) {
+      logStatistics();
+    }
+  }
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "adaptationAgent/use_case_scheduler.hpp"
+
+UseCaseScheduler::UseCaseScheduler(
+  std::chrono::milliseconds min_dwell, std::chrono::milliseconds debounce)
+: min_dwell_(min_dwell), debounce_(debounce), dwell_(min_dwell), pending_debounce_(true)
+{
+}
+
+void UseCaseScheduler::setPolicy(
+  std::chrono::milliseconds min_dwell, std::chrono::milliseconds debounce)
+{
+  min_dwell_ = min_dwell;
+  debounce_ = debounce;
+}
+
+void UseCaseScheduler::setDwell(UseCase use_case, std::chrono::milliseconds min_dwell)
+{
+  dwells_[use_case] = min_dwell;
+}
+
+bool UseCaseScheduler::shouldSwitch(
+  UseCase current, UseCase selected, Clock::time_point now, bool debounce)
+{
+  if (selected == current) {
+    pending_.reset();
+    return false;
+  }
+  if (selected == UseCase::CHARGING) {
+    return true;
+  }
+
+  // The debounce window starts again each time the selection changes
+  if (!pending_.has_value() || pending_.value() != selected) {
+    pending_ = selected;
+    pending_since_ = now;
+  }
+  pending_debounce_ = debounce;
+  return remaining(now).count() == 0;
+}
+
+std::chrono::milliseconds UseCaseScheduler::remaining(Clock::time_point now) const
+{
+  if (!pending_.has_value()) {
+    return std::chrono::milliseconds(0);
+  }
+  auto allowed = pending_debounce_ ? pending_since_ + debounce_ : pending_since_;
+  if (dwell_start_.has_value()) {
+    allowed = std::max(allowed, dwell_start_.value() + dwell_);
+  }
+  if (allowed <= now) {
+    return std::chrono::milliseconds(0);
+  }
+  return std::chrono::ceil<std::chrono::milliseconds>(allowed - now);
+}
+
+void UseCaseScheduler::switched(UseCase use_case, Clock::time_point now)
+{
+  auto dwell = dwells_.find(use_case);
+  dwell_ = dwell != dwells_.end() ? dwell->second : min_dwell_;
+  dwell_start_ = now;
+  pending_.reset();
+}
+
+void UseCaseScheduler::release()
+{
+  dwell_start_.reset();
+}
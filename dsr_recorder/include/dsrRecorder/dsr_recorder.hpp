@@ -0,0 +1,101 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DSRRECORDER__DSR_RECORDER_HPP_
+#define DSRRECORDER__DSR_RECORDER_HPP_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qt
+#include <QObject>
+#include <QTimer>
+
+// DSR
+#include "dsr/api/dsr_api.h"
+
+#include "dsrRecorder/record_log.hpp"
+
+/**
+ * @brief DSR agent that writes every change of the graph to a binary log.
+ * The log starts with a snapshot of the graph, so it can be replayed from the same state.
+ */
+class DsrRecorder : public QObject
+{
+  Q_OBJECT
+
+public:
+  /**
+   * @brief Construct a new DsrRecorder object, write the snapshot and start recording.
+   *
+   * @param agent_name The name of the agent.
+   * @param agent_id The ID of the agent.
+   * @param record_file The path to the log file.
+   */
+  DsrRecorder(std::string agent_name, int agent_id, std::string record_file);
+
+  /**
+   * @brief Destroy the DsrRecorder object. Flush the remaining records.
+   */
+  ~DsrRecorder();
+
+public slots:
+  /**
+   * @brief Write the buffered records to the file.
+   */
+  void flush();
+
+  // DSR callbacks
+  void node_updated(std::uint64_t id, const std::string & type, DSR::SignalInfo info);
+  void node_attributes_updated(
+    std::uint64_t id, const std::vector<std::string> & att_names, DSR::SignalInfo info);
+  void node_deleted(std::uint64_t id, DSR::SignalInfo info);
+  void edge_created(
+    std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info);
+  void edge_updated(
+    std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info);
+  void edge_attributes_updated(
+    std::uint64_t from, std::uint64_t to, const std::string & type,
+    const std::vector<std::string> & att_names, DSR::SignalInfo info);
+  void edge_deleted(
+    std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info);
+
+private:
+  /**
+   * @brief Write all the nodes and edges of the graph.
+   */
+  void writeSnapshot();
+
+  /**
+   * @brief Write a record with the current timestamp.
+   *
+   * @param record The record.
+   */
+  void write(Record record);
+
+  // DSR graph
+  std::shared_ptr<DSR::DSRGraph> G_;
+
+  // Log
+  RecordWriter writer_;
+  std::chrono::steady_clock::time_point start_;
+  uint64_t records_;
+  QTimer flush_timer_;
+  static constexpr int kFlushPeriod = 1000;
+};
+
+#endif  // DSRRECORDER__DSR_RECORDER_HPP_
@@ -0,0 +1,178 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DSRRECORDER__DSR_REPLAYER_HPP_
+#define DSRRECORDER__DSR_REPLAYER_HPP_
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Qt
+#include <QObject>
+#include <QTimer>
+
+// DSR
+#include "dsr/api/dsr_api.h"
+
+#include "dsrRecorder/record_log.hpp"
+#include "../../../include/latency_histogram.hpp"
+
+/**
+ * @brief DSR agent that applies the changes of a log to the graph shared with the agent
+ * under test, and reports the changes that agent makes in response.
+ * The changes recorded from the agent under test are not applied, because the agent makes
+ * them again when it receives the same inputs.
+ */
+class DsrReplayer : public QObject
+{
+  Q_OBJECT
+
+public:
+  /**
+   * @brief Construct a new DsrReplayer object.
+   *
+   * @param agent_name The name of the agent.
+   * @param agent_id The ID of the agent.
+   * @param record_file The path to the log file.
+   * @param speed The speed of the replay relative to the recording. 0 to replay as fast
+   * as possible.
+   * @param target_agent_id The ID of the agent under test. 0 to replay all the changes
+   * and report the changes of any other agent.
+   */
+  DsrReplayer(
+    std::string agent_name, int agent_id, std::string record_file, double speed,
+    uint32_t target_agent_id);
+
+  /**
+   * @brief Destroy the DsrReplayer object.
+   */
+  ~DsrReplayer();
+
+  /**
+   * @brief Start the replay.
+   */
+  void start();
+
+public slots:
+  /**
+   * @brief Apply the next record of the log and schedule the following one.
+   */
+  void step();
+
+  /**
+   * @brief Print the summary of the replay and quit.
+   */
+  void finish();
+
+  // DSR callbacks
+  void node_updated(std::uint64_t id, const std::string & type, DSR::SignalInfo info);
+  void node_attributes_updated(
+    std::uint64_t id, const std::vector<std::string> & att_names, DSR::SignalInfo info);
+  void node_deleted(std::uint64_t id, DSR::SignalInfo info);
+  void edge_created(
+    std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info);
+  void edge_updated(
+    std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info);
+  void edge_attributes_updated(
+    std::uint64_t from, std::uint64_t to, const std::string & type,
+    const std::vector<std::string> & att_names, DSR::SignalInfo info);
+  void edge_deleted(
+    std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info);
+
+private:
+  /**
+   * @brief Apply a record to the graph.
+   *
+   * @param record The record.
+   * @return bool True if the record was applied.
+   */
+  bool apply(const Record & record);
+
+  /**
+   * @brief Get the ID in the live graph of a recorded node.
+   * The nodes not seen before are looked up by name.
+   *
+   * @param record_id The ID of the node in the log.
+   * @param name The name of the node, if known.
+   * @return std::optional<uint64_t> The ID of the node in the live graph.
+   */
+  std::optional<uint64_t> liveId(uint64_t record_id, const std::string & name = "");
+
+  /**
+   * @brief Copy the attributes as if they were written by this agent.
+   *
+   * @param attrs The recorded attributes.
+   * @return std::map<std::string, DSR::Attribute> The attributes to write.
+   */
+  std::map<std::string, DSR::Attribute> ownAttributes(
+    const std::map<std::string, DSR::Attribute> & attrs);
+
+  /**
+   * @brief Check if the change was made by the agent under test.
+   *
+   * @param agent_id The ID of the agent that changed the graph.
+   * @return bool True if the change must be reported.
+   */
+  bool isTarget(uint32_t agent_id);
+
+  /**
+   * @brief Report a change made by the agent under test.
+   *
+   * @param type The type of the change.
+   * @param description The description of the change.
+   */
+  void reportMutation(RecordType type, const std::string & description);
+
+  /**
+   * @brief Describe an edge with the names of its nodes.
+   */
+  std::string describeEdge(std::uint64_t from, std::uint64_t to, const std::string & type);
+
+  // DSR graph
+  std::shared_ptr<DSR::DSRGraph> G_;
+  uint32_t agent_id_;
+
+  // Log
+  RecordReader reader_;
+  Record next_;
+  bool has_next_;
+  double speed_;
+  uint32_t target_agent_id_;
+  std::unordered_map<uint64_t, uint64_t> id_map_;
+  QTimer step_timer_;
+  QTimer settle_timer_;
+  // Time to wait for the last reactions of the agent under test
+  static constexpr int kSettleTime = 2000;
+
+  // Statistics
+  std::chrono::steady_clock::time_point start_;
+  uint64_t replayed_;
+  uint64_t skipped_;
+  uint64_t unresolved_;
+  LatencyHistogram apply_latency_;
+  // Type of the last record applied and when, to measure the reaction of the agent
+  RecordType last_applied_;
+  std::chrono::steady_clock::time_point last_apply_time_;
+  bool awaiting_reaction_;
+  std::map<RecordType, LatencyHistogram> reaction_latency_;
+  std::map<RecordType, uint64_t> mutations_;
+};
+
+#endif  // DSRRECORDER__DSR_REPLAYER_HPP_
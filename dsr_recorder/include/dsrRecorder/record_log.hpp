@@ -0,0 +1,127 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DSRRECORDER__RECORD_LOG_HPP_
+#define DSRRECORDER__RECORD_LOG_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+
+// DSR
+#include "dsr/api/dsr_api.h"
+
+/**
+ * @brief Type of change of the DSR graph stored in a record.
+ */
+enum class RecordType : uint8_t
+{
+  SNAPSHOT_NODE,
+  SNAPSHOT_EDGE,
+  UPDATE_NODE,
+  UPDATE_NODE_ATTR,
+  DELETE_NODE,
+  CREATE_EDGE,
+  UPDATE_EDGE,
+  UPDATE_EDGE_ATTR,
+  DELETE_EDGE
+};
+
+/**
+ * @brief Get the name of the record type.
+ *
+ * @param type The record type.
+ * @return std::string The name of the record type.
+ */
+std::string toStr(RecordType type);
+
+/**
+ * @brief Change of the DSR graph. The nodes use 'id', 'type' and 'name' and the edges use
+ * 'id' as the origin node, 'to' as the destination node and 'type'.
+ */
+struct Record
+{
+  RecordType record_type;
+  // Nanoseconds since the start of the recording
+  uint64_t timestamp;
+  // Agent that changed the graph
+  uint32_t agent_id;
+  uint64_t id;
+  uint64_t to;
+  std::string type;
+  std::string name;
+  // Only the changed attributes in the attribute updates
+  std::map<std::string, DSR::Attribute> attrs;
+};
+
+/**
+ * @brief Append-only binary log of records.
+ * The file starts with a magic header followed by the records one after another.
+ */
+class RecordWriter
+{
+public:
+  /**
+   * @brief Open the log file and write the header.
+   *
+   * @param filepath The path to the log file. It is overwritten if it exists.
+   * @return bool True if the file could be opened.
+   */
+  bool open(const std::string & filepath);
+
+  /**
+   * @brief Append a record to the log.
+   *
+   * @param record The record.
+   */
+  void write(const Record & record);
+
+  /**
+   * @brief Write the buffered records to the file.
+   */
+  void flush();
+
+private:
+  std::ofstream file_;
+};
+
+/**
+ * @brief Sequential reader of a log written by RecordWriter.
+ */
+class RecordReader
+{
+public:
+  /**
+   * @brief Open the log file and check the header.
+   *
+   * @param filepath The path to the log file.
+   * @return bool True if the file could be opened and it is a valid log.
+   */
+  bool open(const std::string & filepath);
+
+  /**
+   * @brief Read the next record of the log.
+   *
+   * @param record The record read.
+   * @return bool False if the end of the log was reached or the record is truncated.
+   */
+  bool next(Record & record);
+
+private:
+  std::ifstream file_;
+};
+
+#endif  // DSRRECORDER__RECORD_LOG_HPP_
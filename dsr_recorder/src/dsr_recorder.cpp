@@ -0,0 +1,179 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dsrRecorder/dsr_recorder.hpp"
+
+DsrRecorder::DsrRecorder(std::string agent_name, int agent_id, std::string record_file)
+: records_(0)
+{
+  if (!writer_.open(record_file)) {
+    throw std::runtime_error("Unable to open the record file: " + record_file);
+  }
+
+  // Register types
+  qRegisterMetaType<DSR::Node>("Node");
+  qRegisterMetaType<DSR::Edge>("Edge");
+  qRegisterMetaType<uint64_t>("uint64_t");
+  qRegisterMetaType<std::string>("std::string");
+  qRegisterMetaType<std::vector<std::string>>("std::vector<std::string>");
+  qRegisterMetaType<DSR::SignalInfo>("DSR::SignalInfo");
+
+  // Create the DSR graph
+  G_ = std::make_shared<DSR::DSRGraph>(agent_name, agent_id, "");
+
+  // The snapshot is written before connecting the signals, so it is the first thing in the log
+  start_ = std::chrono::steady_clock::now();
+  writeSnapshot();
+
+  // Add connection signals
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_node_signal, this, &DsrRecorder::node_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_node_attr_signal, this,
+    &DsrRecorder::node_attributes_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::del_node_signal, this, &DsrRecorder::node_deleted);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::create_edge_signal, this, &DsrRecorder::edge_created);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_edge_signal, this, &DsrRecorder::edge_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_edge_attr_signal, this,
+    &DsrRecorder::edge_attributes_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::del_edge_signal, this, &DsrRecorder::edge_deleted);
+
+  // Flush the records periodically, so a crash only loses the last period
+  QObject::connect(&flush_timer_, SIGNAL(timeout()), this, SLOT(flush()));
+  flush_timer_.start(kFlushPeriod);
+
+  std::cout << "Recording the DSR graph in " << record_file << std::endl;
+}
+
+DsrRecorder::~DsrRecorder()
+{
+  flush();
+  std::cout << "Recorded " << records_ << " changes of the DSR graph" << std::endl;
+  G_.reset();
+}
+
+void DsrRecorder::flush()
+{
+  writer_.flush();
+}
+
+void DsrRecorder::writeSnapshot()
+{
+  auto nodes = G_->get_copy();
+  for (const auto & [id, node] : nodes) {
+    write({RecordType::SNAPSHOT_NODE, 0, node.agent_id(), id, 0, node.type(), node.name(),
+        node.attrs()});
+  }
+  for (const auto & [id, node] : nodes) {
+    for (const auto & [key, edge] : node.fano()) {
+      write({RecordType::SNAPSHOT_EDGE, 0, edge.agent_id(), edge.from(), edge.to(), edge.type(),
+          "", edge.attrs()});
+    }
+  }
+  flush();
+}
+
+void DsrRecorder::write(Record record)
+{
+  // The snapshot is always at the start of the log
+  if (record.record_type != RecordType::SNAPSHOT_NODE &&
+    record.record_type != RecordType::SNAPSHOT_EDGE)
+  {
+    record.timestamp = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+  }
+  writer_.write(record);
+  records_++;
+}
+
+// DSR callbacks
+// ----------------------------------------------------------------------------
+
+void DsrRecorder::node_updated(std::uint64_t id, const std::string & type, DSR::SignalInfo info)
+{
+  if (auto node = G_->get_node(id); node.has_value()) {
+    write({RecordType::UPDATE_NODE, 0, info.agent_id, id, 0, type, node.value().name(),
+        node.value().attrs()});
+  }
+}
+
+void DsrRecorder::node_attributes_updated(
+  std::uint64_t id, const std::vector<std::string> & att_names, DSR::SignalInfo info)
+{
+  if (auto node = G_->get_node(id); node.has_value()) {
+    // Only the attributes that have changed
+    std::map<std::string, DSR::Attribute> attrs;
+    for (const auto & att_name : att_names) {
+      if (auto it = node.value().attrs().find(att_name); it != node.value().attrs().end()) {
+        attrs.insert(*it);
+      }
+    }
+    write({RecordType::UPDATE_NODE_ATTR, 0, info.agent_id, id, 0, node.value().type(),
+        node.value().name(), attrs});
+  }
+}
+
+void DsrRecorder::node_deleted(std::uint64_t id, DSR::SignalInfo info)
+{
+  write({RecordType::DELETE_NODE, 0, info.agent_id, id, 0, "", "", {}});
+}
+
+void DsrRecorder::edge_created(
+  std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info)
+{
+  if (auto edge = G_->get_edge(from, to, type); edge.has_value()) {
+    write({RecordType::CREATE_EDGE, 0, info.agent_id, from, to, type, "", edge.value().attrs()});
+  }
+}
+
+void DsrRecorder::edge_updated(
+  std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info)
+{
+  if (auto edge = G_->get_edge(from, to, type); edge.has_value()) {
+    write({RecordType::UPDATE_EDGE, 0, info.agent_id, from, to, type, "", edge.value().attrs()});
+  }
+}
+
+void DsrRecorder::edge_attributes_updated(
+  std::uint64_t from, std::uint64_t to, const std::string & type,
+  const std::vector<std::string> & att_names, DSR::SignalInfo info)
+{
+  if (auto edge = G_->get_edge(from, to, type); edge.has_value()) {
+    std::map<std::string, DSR::Attribute> attrs;
+    for (const auto & att_name : att_names) {
+      if (auto it = edge.value().attrs().find(att_name); it != edge.value().attrs().end()) {
+        attrs.insert(*it);
+      }
+    }
+    write({RecordType::UPDATE_EDGE_ATTR, 0, info.agent_id, from, to, type, "", attrs});
+  }
+}
+
+void DsrRecorder::edge_deleted(
+  std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info)
+{
+  write({RecordType::DELETE_EDGE, 0, info.agent_id, from, to, type, "", {}});
+}
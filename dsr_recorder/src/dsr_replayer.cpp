@@ -0,0 +1,362 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <QCoreApplication>
+
+#include "dsrRecorder/dsr_replayer.hpp"
+
+DsrReplayer::DsrReplayer(
+  std::string agent_name, int agent_id, std::string record_file, double speed,
+  uint32_t target_agent_id)
+: agent_id_(static_cast<uint32_t>(agent_id)), has_next_(false), speed_(speed),
+  target_agent_id_(target_agent_id), replayed_(0), skipped_(0), unresolved_(0),
+  last_applied_(RecordType::SNAPSHOT_NODE), awaiting_reaction_(false)
+{
+  if (!reader_.open(record_file)) {
+    throw std::runtime_error("Invalid record file: " + record_file);
+  }
+
+  // Register types
+  qRegisterMetaType<DSR::Node>("Node");
+  qRegisterMetaType<DSR::Edge>("Edge");
+  qRegisterMetaType<uint64_t>("uint64_t");
+  qRegisterMetaType<std::string>("std::string");
+  qRegisterMetaType<std::vector<std::string>>("std::vector<std::string>");
+  qRegisterMetaType<DSR::SignalInfo>("DSR::SignalInfo");
+
+  // Create the DSR graph
+  G_ = std::make_shared<DSR::DSRGraph>(agent_name, agent_id, "");
+
+  // Add connection signals
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_node_signal, this, &DsrReplayer::node_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_node_attr_signal, this,
+    &DsrReplayer::node_attributes_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::del_node_signal, this, &DsrReplayer::node_deleted);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::create_edge_signal, this, &DsrReplayer::edge_created);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_edge_signal, this, &DsrReplayer::edge_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::update_edge_attr_signal, this,
+    &DsrReplayer::edge_attributes_updated);
+  QObject::connect(
+    G_.get(), &DSR::DSRGraph::del_edge_signal, this, &DsrReplayer::edge_deleted);
+
+  QObject::connect(&step_timer_, SIGNAL(timeout()), this, SLOT(step()));
+  QObject::connect(&settle_timer_, SIGNAL(timeout()), this, SLOT(finish()));
+  step_timer_.setSingleShot(true);
+  settle_timer_.setSingleShot(true);
+}
+
+DsrReplayer::~DsrReplayer()
+{
+  G_.reset();
+}
+
+void DsrReplayer::start()
+{
+  has_next_ = reader_.next(next_);
+  start_ = std::chrono::steady_clock::now();
+  step_timer_.start(0);
+}
+
+void DsrReplayer::step()
+{
+  if (!has_next_) {
+    settle_timer_.start(kSettleTime);
+    return;
+  }
+
+  // The changes of the agent under test are not applied
+  if (target_agent_id_ != 0 && next_.agent_id == target_agent_id_ &&
+    next_.record_type != RecordType::SNAPSHOT_NODE &&
+    next_.record_type != RecordType::SNAPSHOT_EDGE)
+  {
+    skipped_++;
+  } else {
+    auto apply_start = std::chrono::steady_clock::now();
+    if (apply(next_)) {
+      auto apply_end = std::chrono::steady_clock::now();
+      apply_latency_.record(apply_end - apply_start);
+      replayed_++;
+      last_applied_ = next_.record_type;
+      last_apply_time_ = apply_end;
+      awaiting_reaction_ = true;
+    } else {
+      unresolved_++;
+    }
+  }
+
+  // Schedule the next record at the recorded time or as soon as possible
+  has_next_ = reader_.next(next_);
+  int delay = 0;
+  if (has_next_ && speed_ > 0.0) {
+    auto target_time = start_ + std::chrono::nanoseconds(
+      static_cast<int64_t>(static_cast<double>(next_.timestamp) / speed_));
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      target_time - std::chrono::steady_clock::now());
+    delay = static_cast<int>(std::max<int64_t>(remaining.count(), 0));
+  }
+  step_timer_.start(delay);
+}
+
+void DsrReplayer::finish()
+{
+  // The settle time is not part of the replay
+  auto elapsed = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start_ -
+    std::chrono::milliseconds(kSettleTime)).count();
+
+  std::cout << std::endl << "Replay finished" << std::endl;
+  std::cout << "  Records applied: " << replayed_ << ", skipped: " << skipped_ <<
+    ", unresolved: " << unresolved_ << std::endl;
+  std::cout << "  Time: " << elapsed << " s, throughput: " <<
+    (elapsed > 0.0 ? static_cast<double>(replayed_) / elapsed : 0.0) << " records/s" <<
+    std::endl;
+  std::cout << "  Apply latency: " << apply_latency_.summary() << std::endl;
+  std::cout << "Changes made by the agent under test:" << std::endl;
+  for (const auto & [type, count] : mutations_) {
+    std::cout << "  " << toStr(type) << ": " << count << std::endl;
+  }
+  std::cout << "Reaction latency by the type of the change that triggered it:" << std::endl;
+  for (const auto & [type, latency] : reaction_latency_) {
+    std::cout << "  " << toStr(type) << ": " << latency.summary() << std::endl;
+  }
+
+  QCoreApplication::quit();
+}
+
+bool DsrReplayer::apply(const Record & record)
+{
+  switch (record.record_type) {
+    case RecordType::SNAPSHOT_NODE:
+    case RecordType::UPDATE_NODE:
+      {
+        // Update the node if it already exists in the live graph or insert it
+        if (auto id = liveId(record.id, record.name); id.has_value()) {
+          if (auto node = G_->get_node(id.value()); node.has_value()) {
+            node.value().attrs() = ownAttributes(record.attrs);
+            return G_->update_node(node.value());
+          }
+          return false;
+        }
+        DSR::Node node;
+        node.type(record.type);
+        node.name(record.name);
+        node.agent_id(agent_id_);
+        node.attrs() = ownAttributes(record.attrs);
+        if (auto id = G_->insert_node(node); id.has_value()) {
+          id_map_[record.id] = id.value();
+          return true;
+        }
+        return false;
+      }
+    case RecordType::UPDATE_NODE_ATTR:
+      {
+        auto id = liveId(record.id, record.name);
+        if (!id.has_value()) {
+          return false;
+        }
+        auto node = G_->get_node(id.value());
+        if (!node.has_value()) {
+          return false;
+        }
+        for (const auto & [name, attr] : ownAttributes(record.attrs)) {
+          node.value().attrs()[name] = attr;
+        }
+        return G_->update_node(node.value());
+      }
+    case RecordType::DELETE_NODE:
+      {
+        auto id = liveId(record.id);
+        if (!id.has_value()) {
+          return false;
+        }
+        id_map_.erase(record.id);
+        return G_->delete_node(id.value());
+      }
+    case RecordType::SNAPSHOT_EDGE:
+    case RecordType::CREATE_EDGE:
+    case RecordType::UPDATE_EDGE:
+    case RecordType::UPDATE_EDGE_ATTR:
+      {
+        auto from = liveId(record.id);
+        auto to = liveId(record.to);
+        if (!from.has_value() || !to.has_value()) {
+          return false;
+        }
+        // The attribute updates only contain the changed attributes
+        DSR::Edge edge;
+        if (auto current = G_->get_edge(from.value(), to.value(), record.type);
+          record.record_type == RecordType::UPDATE_EDGE_ATTR && current.has_value())
+        {
+          edge = current.value();
+        } else {
+          edge.from(from.value());
+          edge.to(to.value());
+          edge.type(record.type);
+          edge.agent_id(agent_id_);
+        }
+        for (const auto & [name, attr] : ownAttributes(record.attrs)) {
+          edge.attrs()[name] = attr;
+        }
+        return G_->insert_or_assign_edge(edge);
+      }
+    case RecordType::DELETE_EDGE:
+      {
+        auto from = liveId(record.id);
+        auto to = liveId(record.to);
+        if (!from.has_value() || !to.has_value()) {
+          return false;
+        }
+        return G_->delete_edge(from.value(), to.value(), record.type);
+      }
+  }
+  return false;
+}
+
+std::optional<uint64_t> DsrReplayer::liveId(uint64_t record_id, const std::string & name)
+{
+  if (auto it = id_map_.find(record_id); it != id_map_.end()) {
+    return it->second;
+  }
+  if (!name.empty()) {
+    if (auto node = G_->get_node(name); node.has_value()) {
+      id_map_[record_id] = node.value().id();
+      return node.value().id();
+    }
+  }
+  return std::nullopt;
+}
+
+std::map<std::string, DSR::Attribute> DsrReplayer::ownAttributes(
+  const std::map<std::string, DSR::Attribute> & attrs)
+{
+  std::map<std::string, DSR::Attribute> own_attrs;
+  for (const auto & [name, attr] : attrs) {
+    own_attrs[name] = DSR::Attribute(attr.value(), attr.timestamp(), agent_id_);
+  }
+  return own_attrs;
+}
+
+bool DsrReplayer::isTarget(uint32_t agent_id)
+{
+  return agent_id != agent_id_ && (target_agent_id_ == 0 || agent_id == target_agent_id_);
+}
+
+void DsrReplayer::reportMutation(RecordType type, const std::string & description)
+{
+  auto now = std::chrono::steady_clock::now();
+  mutations_[type]++;
+  // Only the first change after a record is its reaction
+  if (awaiting_reaction_) {
+    reaction_latency_[last_applied_].record(now - last_apply_time_);
+    awaiting_reaction_ = false;
+  }
+  auto time = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_).count();
+  std::cout << "[" << time << " ms] " << toStr(type) << ": " << description << std::endl;
+}
+
+std::string DsrReplayer::describeEdge(
+  std::uint64_t from, std::uint64_t to, const std::string & type)
+{
+  auto from_name = G_->get_name_from_id(from);
+  auto to_name = G_->get_name_from_id(to);
+  return from_name.value_or(std::to_string(from)) + " ---(" + type + ")---> " +
+         to_name.value_or(std::to_string(to));
+}
+
+// DSR callbacks
+// ----------------------------------------------------------------------------
+
+void DsrReplayer::node_updated(std::uint64_t id, const std::string & type, DSR::SignalInfo info)
+{
+  if (isTarget(info.agent_id)) {
+    auto name = G_->get_name_from_id(id);
+    reportMutation(RecordType::UPDATE_NODE, name.value_or(std::to_string(id)) + " (" + type + ")");
+  }
+}
+
+void DsrReplayer::node_attributes_updated(
+  std::uint64_t id, const std::vector<std::string> & att_names, DSR::SignalInfo info)
+{
+  if (!isTarget(info.agent_id)) {
+    return;
+  }
+  auto node = G_->get_node(id);
+  std::string description = node.has_value() ? node.value().name() : std::to_string(id);
+  // The text attributes show the decisions, such as the use case selected
+  for (const auto & att_name : att_names) {
+    description += " " + att_name;
+    if (node.has_value()) {
+      auto it = node.value().attrs().find(att_name);
+      if (it != node.value().attrs().end()) {
+        if (auto value = std::get_if<std::string>(&it->second.value()); value != nullptr) {
+          description += "=" + *value;
+        }
+      }
+    }
+  }
+  reportMutation(RecordType::UPDATE_NODE_ATTR, description);
+}
+
+void DsrReplayer::node_deleted(std::uint64_t id, DSR::SignalInfo info)
+{
+  if (isTarget(info.agent_id)) {
+    reportMutation(RecordType::DELETE_NODE, std::to_string(id));
+  }
+}
+
+void DsrReplayer::edge_created(
+  std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info)
+{
+  if (isTarget(info.agent_id)) {
+    reportMutation(RecordType::CREATE_EDGE, describeEdge(from, to, type));
+  }
+}
+
+void DsrReplayer::edge_updated(
+  std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info)
+{
+  if (isTarget(info.agent_id)) {
+    reportMutation(RecordType::UPDATE_EDGE, describeEdge(from, to, type));
+  }
+}
+
+void DsrReplayer::edge_attributes_updated(
+  std::uint64_t from, std::uint64_t to, const std::string & type,
+  const std::vector<std::string> & /*att_names*/, DSR::SignalInfo info)
+{
+  if (isTarget(info.agent_id)) {
+    reportMutation(RecordType::UPDATE_EDGE_ATTR, describeEdge(from, to, type));
+  }
+}
+
+void DsrReplayer::edge_deleted(
+  std::uint64_t from, std::uint64_t to, const std::string & type, DSR::SignalInfo info)
+{
+  if (isTarget(info.agent_id)) {
+    reportMutation(RecordType::DELETE_EDGE, describeEdge(from, to, type));
+  }
+}
@@ -0,0 +1,204 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "dsrRecorder/record_log.hpp"
+
+namespace
+{
+
+// Header at the start of every log. The last two characters are the format version
+constexpr std::array<char, 8> kMagic = {'D', 'S', 'R', 'R', 'E', 'C', '0', '1'};
+
+// Fields are written in the byte order of the host
+template<typename T>
+void writeField(std::ostream & out, const T & value)
+{
+  if constexpr (std::is_arithmetic_v<T>) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    writeField(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+  } else {
+    // std::vector and std::array of arithmetic types
+    if constexpr (std::is_same_v<T, std::vector<typename T::value_type>>) {
+      writeField(out, static_cast<uint32_t>(value.size()));
+    }
+    for (const auto & item : value) {
+      writeField(out, item);
+    }
+  }
+}
+
+template<typename T>
+void readField(std::istream & in, T & value)
+{
+  if constexpr (std::is_arithmetic_v<T>) {
+    in.read(reinterpret_cast<char *>(&value), sizeof(T));
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    uint32_t size = 0;
+    readField(in, size);
+    if (in) {
+      value.resize(size);
+      in.read(value.data(), static_cast<std::streamsize>(size));
+    }
+  } else {
+    if constexpr (std::is_same_v<T, std::vector<typename T::value_type>>) {
+      uint32_t size = 0;
+      readField(in, size);
+      if (!in) {
+        return;
+      }
+      value.resize(size);
+    }
+    for (auto & item : value) {
+      readField(in, item);
+    }
+  }
+}
+
+// Build the alternative of the attribute value stored at the given index
+template<std::size_t I = 0>
+DSR::ValType readValue(std::istream & in, std::size_t index)
+{
+  if constexpr (I < std::variant_size_v<DSR::ValType>) {
+    if (index == I) {
+      std::variant_alternative_t<I, DSR::ValType> value{};
+      readField(in, value);
+      return value;
+    }
+    return readValue<I + 1>(in, index);
+  } else {
+    in.setstate(std::ios::failbit);
+    return DSR::ValType{};
+  }
+}
+
+void writeAttributes(std::ostream & out, const std::map<std::string, DSR::Attribute> & attrs)
+{
+  writeField(out, static_cast<uint32_t>(attrs.size()));
+  for (const auto & [name, attr] : attrs) {
+    writeField(out, name);
+    writeField(out, static_cast<uint8_t>(attr.value().index()));
+    std::visit([&out](const auto & value) {writeField(out, value);}, attr.value());
+    writeField(out, attr.timestamp());
+    writeField(out, attr.agent_id());
+  }
+}
+
+void readAttributes(std::istream & in, std::map<std::string, DSR::Attribute> & attrs)
+{
+  uint32_t size = 0;
+  readField(in, size);
+  for (uint32_t i = 0; i < size && in; ++i) {
+    std::string name;
+    uint8_t index = 0;
+    uint64_t timestamp = 0;
+    uint32_t agent_id = 0;
+    readField(in, name);
+    readField(in, index);
+    auto value = readValue(in, index);
+    readField(in, timestamp);
+    readField(in, agent_id);
+    attrs[name] = DSR::Attribute(value, timestamp, agent_id);
+  }
+}
+
+}  // namespace
+
+std::string toStr(RecordType type)
+{
+  switch (type) {
+    case RecordType::SNAPSHOT_NODE:
+      return "snapshot_node";
+    case RecordType::SNAPSHOT_EDGE:
+      return "snapshot_edge";
+    case RecordType::UPDATE_NODE:
+      return "update_node";
+    case RecordType::UPDATE_NODE_ATTR:
+      return "update_node_attr";
+    case RecordType::DELETE_NODE:
+      return "delete_node";
+    case RecordType::CREATE_EDGE:
+      return "create_edge";
+    case RecordType::UPDATE_EDGE:
+      return "update_edge";
+    case RecordType::UPDATE_EDGE_ATTR:
+      return "update_edge_attr";
+    case RecordType::DELETE_EDGE:
+      return "delete_edge";
+  }
+  return "unknown";
+}
+
+bool RecordWriter::open(const std::string & filepath)
+{
+  file_.open(filepath, std::ios::binary | std::ios::trunc);
+  if (!file_.is_open()) {
+    return false;
+  }
+  file_.write(kMagic.data(), kMagic.size());
+  return file_.good();
+}
+
+void RecordWriter::write(const Record & record)
+{
+  writeField(file_, static_cast<uint8_t>(record.record_type));
+  writeField(file_, record.timestamp);
+  writeField(file_, record.agent_id);
+  writeField(file_, record.id);
+  writeField(file_, record.to);
+  writeField(file_, record.type);
+  writeField(file_, record.name);
+  writeAttributes(file_, record.attrs);
+}
+
+void RecordWriter::flush()
+{
+  file_.flush();
+}
+
+bool RecordReader::open(const std::string & filepath)
+{
+  file_.open(filepath, std::ios::binary);
+  std::array<char, kMagic.size()> magic{};
+  file_.read(magic.data(), magic.size());
+  return file_.good() && magic == kMagic;
+}
+
+bool RecordReader::next(Record & record)
+{
+  uint8_t record_type = 0;
+  readField(file_, record_type);
+  if (!file_ || record_type > static_cast<uint8_t>(RecordType::DELETE_EDGE)) {
+    return false;
+  }
+  record.record_type = static_cast<RecordType>(record_type);
+  record.attrs.clear();
+  readField(file_, record.timestamp);
+  readField(file_, record.agent_id);
+  readField(file_, record.id);
+  readField(file_, record.to);
+  readField(file_, record.type);
+  readField(file_, record.name);
+  readAttributes(file_, record.attrs);
+  return static_cast<bool>(file_);
+}
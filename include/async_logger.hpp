@@ -0,0 +1,158 @@
+#ifndef ASYNC_LOGGER
+#define ASYNC_LOGGER
+
+// C++
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// SPDLOG
+#include "spdlog/spdlog.h"
+#include "spdlog/async.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+/**
+ * @brief Parameters of the loggers of the agents.
+ */
+struct loggerParameters
+{
+  // Messages in the queue of the logging thread, shared by all the loggers of the process
+  std::size_t queue_size = 8192;
+  // What to do when the queue is full: drop the oldest message or wait for the disk
+  spdlog::async_overflow_policy overflow_policy =
+    spdlog::async_overflow_policy::overrun_oldest;
+  // Size in bytes of a log file before rotating it and number of old files kept
+  std::size_t max_file_size = 10 * 1024 * 1024;
+  std::size_t max_files = 5;
+  spdlog::level::level_enum console_level = spdlog::level::info;
+  spdlog::level::level_enum file_level = spdlog::level::debug;
+};
+
+/**
+ * @brief Parse a log level of the configuration. spdlog turns an unknown name into 'off',
+ * which would silently disable the sink, so the default level is kept instead.
+ *
+ * @param name The name of the level.
+ * @param default_level The level used if the name is unknown.
+ * @return spdlog::level::level_enum The level.
+ */
+inline spdlog::level::level_enum levelFromConfig(
+  const std::string & name, spdlog::level::level_enum default_level)
+{
+  auto level = spdlog::level::from_str(name);
+  if (level == spdlog::level::off && name != spdlog::level::to_string_view(level)) {
+    spdlog::warn(
+      "Unknown log level '{}', using '{}'", name, spdlog::level::to_string_view(default_level));
+    return default_level;
+  }
+  return level;
+}
+
+/**
+ * @brief Read the parameters of the loggers from the configuration of an agent.
+ * The keys are log_queue_size, log_overflow_policy ('block' or 'overrun_oldest'),
+ * log_max_file_size, log_max_files, log_console_level and log_file_level. The keys missing
+ * keep the default value.
+ *
+ * @param config The configuration of the agent.
+ * @return loggerParameters The parameters of the loggers.
+ */
+inline loggerParameters loggerParametersFromConfig(
+  const std::map<std::string, std::string> & config)
+{
+  loggerParameters params;
+  auto value = [&config](const std::string & key) {
+      auto it = config.find(key);
+      return it != config.end() ? it->second : std::string();
+    };
+
+  if (auto queue_size = value("log_queue_size"); !queue_size.empty()) {
+    params.queue_size = std::stoul(queue_size);
+  }
+  if (auto policy = value("log_overflow_policy"); policy == "block") {
+    params.overflow_policy = spdlog::async_overflow_policy::block;
+  } else if (policy == "overrun_oldest") {
+    params.overflow_policy = spdlog::async_overflow_policy::overrun_oldest;
+  } else if (!policy.empty()) {
+    spdlog::warn("Unknown log overflow policy '{}', using 'overrun_oldest'", policy);
+  }
+  if (auto max_file_size = value("log_max_file_size"); !max_file_size.empty()) {
+    params.max_file_size = std::stoul(max_file_size);
+  }
+  if (auto max_files = value("log_max_files"); !max_files.empty()) {
+    params.max_files = std::stoul(max_files);
+  }
+  if (auto console_level = value("log_console_level"); !console_level.empty()) {
+    params.console_level = levelFromConfig(console_level, params.console_level);
+  }
+  if (auto file_level = value("log_file_level"); !file_level.empty()) {
+    params.file_level = levelFromConfig(file_level, params.file_level);
+  }
+  return params;
+}
+
+/**
+ * @brief Create the console sink of an agent with the console level of the parameters.
+ *
+ * @param params The parameters of the loggers.
+ * @return spdlog::sink_ptr The console sink.
+ */
+inline spdlog::sink_ptr createConsoleSink(const loggerParameters & params)
+{
+  auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+  sink->set_level(params.console_level);
+  return sink;
+}
+
+/**
+ * @brief Create a file sink that rotates when the file reaches the maximum size.
+ *
+ * @param filename The path to the log file.
+ * @param params The parameters of the loggers.
+ * @return spdlog::sink_ptr The file sink.
+ */
+inline spdlog::sink_ptr createFileSink(
+  const std::string & filename, const loggerParameters & params)
+{
+  auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+    filename, params.max_file_size, params.max_files);
+  sink->set_level(params.file_level);
+  return sink;
+}
+
+/**
+ * @brief Create a logger that formats the messages in the calling thread and writes them
+ * to the sinks in a background thread, so a slow disk never blocks the agent unless the
+ * overflow policy is 'block'.
+ * The level of the logger is the lowest level of its sinks.
+ *
+ * @param name The name of the logger.
+ * @param sinks The sinks of the logger.
+ * @param params The parameters of the loggers.
+ * @return std::shared_ptr<spdlog::logger> The logger.
+ */
+inline std::shared_ptr<spdlog::logger> createAsyncLogger(
+  const std::string & name, const std::vector<spdlog::sink_ptr> & sinks,
+  const loggerParameters & params)
+{
+  // The first logger created sets the size of the queue
+  if (!spdlog::thread_pool()) {
+    spdlog::init_thread_pool(params.queue_size, 1);
+  }
+  auto logger = std::make_shared<spdlog::async_logger>(
+    name, sinks.begin(), sinks.end(), spdlog::thread_pool(), params.overflow_policy);
+
+  auto level = spdlog::level::off;
+  for (const auto & sink : sinks) {
+    level = std::min(level, sink->level());
+  }
+  logger->set_level(level);
+  logger->flush_on(spdlog::level::warn);
+  return logger;
+}
+
+#endif  // ASYNC_LOGGER
@@ -0,0 +1,150 @@
+#ifndef LATENCY_HISTOGRAM
+#define LATENCY_HISTOGRAM
+
+// C++
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+/**
+ * @brief Histogram of latencies with logarithmic buckets.
+ * Each power of two is split in 8 sub-buckets, so the percentiles have an error below 12.5%
+ * while the memory used is constant. It is not thread-safe: it must be recorded and read
+ * from the same thread.
+ */
+class LatencyHistogram
+{
+public:
+  /**
+   * @brief Add a new latency to the histogram.
+   *
+   * @param latency The latency to add.
+   */
+  void record(std::chrono::nanoseconds latency)
+  {
+    uint64_t value = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+    buckets_[bucketIndex(value)]++;
+    count_++;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  /**
+   * @brief Get the latency below which the given percentage of samples fall.
+   *
+   * @param percentile The percentile in the range [0, 100].
+   * @return std::chrono::nanoseconds The upper bound of the bucket of the percentile.
+   */
+  std::chrono::nanoseconds percentile(double percentile) const
+  {
+    if (count_ == 0) {
+      return std::chrono::nanoseconds(0);
+    }
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count_));
+    target = std::clamp<uint64_t>(target, 1, count_);
+    uint64_t accumulated = 0;
+    for (std::size_t i = 0; i < kNumBuckets; ++i) {
+      accumulated += buckets_[i];
+      if (accumulated >= target) {
+        return std::chrono::nanoseconds(std::clamp(bucketUpperBound(i), min_, max_));
+      }
+    }
+    return std::chrono::nanoseconds(max_);
+  }
+
+  /**
+   * @brief Get the number of samples.
+   *
+   * @return uint64_t The number of samples recorded.
+   */
+  uint64_t count() const {return count_;}
+
+  /**
+   * @brief Get the mean latency.
+   *
+   * @return std::chrono::nanoseconds The mean of the samples.
+   */
+  std::chrono::nanoseconds mean() const
+  {
+    return std::chrono::nanoseconds(count_ > 0 ? sum_ / count_ : 0);
+  }
+
+  /**
+   * @brief Get the maximum latency.
+   *
+   * @return std::chrono::nanoseconds The maximum of the samples.
+   */
+  std::chrono::nanoseconds max() const {return std::chrono::nanoseconds(max_);}
+
+  /**
+   * @brief Get the total time of all the samples.
+   *
+   * @return std::chrono::nanoseconds The sum of the samples.
+   */
+  std::chrono::nanoseconds total() const {return std::chrono::nanoseconds(sum_);}
+
+  /**
+   * @brief Remove all the samples.
+   */
+  void reset()
+  {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+  }
+
+  /**
+   * @brief Get a summary of the histogram in microseconds.
+   *
+   * @return std::string The summary as 'n=... mean=...us p50=...us p99=...us max=...us'.
+   */
+  std::string summary() const
+  {
+    auto us = [](std::chrono::nanoseconds ns) {
+        return std::to_string(ns.count() / 1000);
+      };
+    return "n=" + std::to_string(count_) + " mean=" + us(mean()) + "us p50=" +
+           us(percentile(50)) + "us p99=" + us(percentile(99)) + "us max=" + us(max()) + "us";
+  }
+
+private:
+  static constexpr std::size_t kSubBucketBits = 3;
+  static constexpr std::size_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr std::size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  static std::size_t bucketIndex(uint64_t value)
+  {
+    if (value < kSubBuckets) {
+      return static_cast<std::size_t>(value);
+    }
+    std::size_t msb = 63 - static_cast<std::size_t>(std::countl_zero(value));
+    std::size_t sub = (value >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+    return (msb - kSubBucketBits + 1) * kSubBuckets + sub;
+  }
+
+  static uint64_t bucketUpperBound(std::size_t index)
+  {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    std::size_t msb = index / kSubBuckets + kSubBucketBits - 1;
+    uint64_t sub = index % kSubBuckets;
+    uint64_t lower = (uint64_t{1} << msb) | (sub << (msb - kSubBucketBits));
+    return lower + (uint64_t{1} << (msb - kSubBucketBits)) - 1;
+  }
+
+  std::array<uint64_t, kNumBuckets> buckets_{};
+  uint64_t count_{0};
+  uint64_t sum_{0};
+  uint64_t min_{std::numeric_limits<uint64_t>::max()};
+  uint64_t max_{0};
+};
+
+#endif  // LATENCY_HISTOGRAM
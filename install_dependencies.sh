@@ -61,7 +61,7 @@ DEBIAN_FRONTEND=noninteractive apt -y update && DEBIAN_FRONTEND=noninteractive a
 # Install dependencies
 echo -e "${CYAN}- First, we will install some dependencies.${ENDCOLOR}"
 DEBIAN_FRONTEND=noninteractive apt install -y curl git cmake make build-essential libboost-all-dev || printError "- The dependencies could not be installed. Please, check the log and try again."
-DEBIAN_FRONTEND=noninteractive apt install -y nlohmann-json3-dev libeigen3-dev libttspico-utils speech-dispatcher sox libwebsockets-dev libzmq3-dev libncurses-dev libspdlog-dev moreutils || printError "- The dependencies could not be installed. Please, check the log and try again."
+DEBIAN_FRONTEND=noninteractive apt install -y nlohmann-json3-dev libeigen3-dev libttspico-utils libttspico-dev libpulse-dev libasound2-dev speech-dispatcher sox libwebsockets-dev libzmq3-dev libncurses-dev libspdlog-dev moreutils || printError "- The dependencies could not be installed. Please, check the log and try again."
 DEBIAN_FRONTED=noninteractive apt install -y libopenscenegraph-dev libtinyxml2-dev qtbase5-dev || printError "- The dependencies could not be installed. Please, check the log and try again."
 
 # Install Oat++
@@ -0,0 +1,103 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__ACTION_QUEUE_HPP_
+#define SPEECHAGENT__ACTION_QUEUE_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <unordered_map>
+
+// Action waiting to be performed
+struct queuedAction
+{
+  uint64_t id;
+  // Priority of the node, the higher the sooner
+  int priority;
+  // Order of arrival, between the actions with the same priority
+  uint64_t arrival;
+};
+
+/**
+ * @brief Queue of the actions ordered by priority and then by arrival.
+ */
+class ActionQueue
+{
+  struct actionOrder
+  {
+    bool operator()(const queuedAction & a, const queuedAction & b) const
+    {
+      return a.priority != b.priority ? a.priority > b.priority : a.arrival < b.arrival;
+    }
+  };
+
+public:
+  using const_iterator = std::set<queuedAction, actionOrder>::const_iterator;
+
+  /**
+   * @brief Construct a new Action Queue object.
+   */
+  ActionQueue();
+
+  /**
+   * @brief Add a new action. It is ignored if the action is already in the queue.
+   *
+   * @param id The id of the action.
+   * @param priority The priority of the action.
+   * @return true If the action was added.
+   */
+  bool push(uint64_t id, int priority);
+
+  /**
+   * @brief Add again an action that was interrupted. It keeps its order of arrival,
+   * so it goes before the actions with the same priority that came after it.
+   *
+   * @param action The action.
+   */
+  void requeue(const queuedAction & action);
+
+  /**
+   * @brief Remove the next action.
+   *
+   * @return std::optional<queuedAction> The next action, if any.
+   */
+  std::optional<queuedAction> pop();
+
+  /**
+   * @brief Remove an action.
+   *
+   * @param id The id of the action.
+   * @return true If the action was in the queue.
+   */
+  bool remove(uint64_t id);
+
+  /**
+   * @brief Check if the queue is empty.
+   *
+   * @return true If there are no actions.
+   */
+  bool empty() const;
+
+  const_iterator begin() const {return actions_.begin();}
+  const_iterator end() const {return actions_.end();}
+
+private:
+  std::set<queuedAction, actionOrder> actions_;
+  std::unordered_map<uint64_t, const_iterator> index_;
+  uint64_t arrivals_;
+};
+
+#endif  // SPEECHAGENT__ACTION_QUEUE_HPP_
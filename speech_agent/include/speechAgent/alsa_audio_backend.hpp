@@ -0,0 +1,100 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__ALSA_AUDIO_BACKEND_HPP_
+#define SPEECHAGENT__ALSA_AUDIO_BACKEND_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "speechAgent/audio_backend.hpp"
+
+struct _snd_pcm;
+
+/**
+ * @brief Playback device of ALSA, for robots without a PulseAudio server. The device is
+ * kept open between buffers with the same format. The master volume is the 'Master'
+ * control of the default card.
+ */
+class AlsaAudioBackend : public AudioBackend
+{
+public:
+  /**
+   * @brief Construct a new Alsa Audio Backend object.
+   *
+   * @param device The name of the ALSA device, like default or plughw:0,0.
+   */
+  explicit AlsaAudioBackend(std::string device);
+
+  /**
+   * @brief Destroy the Alsa Audio Backend object. Close the device.
+   */
+  ~AlsaAudioBackend() override;
+
+  bool write(const audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr) override;
+
+  bool drain(const std::atomic<bool> * cancel = nullptr) override;
+
+protected:
+  bool applyVolume(int percent) override;
+
+  int readVolume() override;
+
+private:
+  /**
+   * @brief Open the device with the format of the audio, if it is not open yet.
+   *
+   * @param buffer The audio.
+   * @return true If the device is open.
+   */
+  bool open(const audioBuffer & buffer);
+
+  /**
+   * @brief Close the device.
+   */
+  void close();
+
+  /**
+   * @brief Discard the audio not played yet and prepare the device for the next audio.
+   */
+  void discard();
+
+  /**
+   * @brief Run a function with the master control of the mixer.
+   *
+   * @param function The function, that gets the control and its range of volume.
+   * @return true If the control was found and the function succeeded.
+   */
+  template<typename Function>
+  bool withMasterControl(Function function);
+
+  static constexpr const char * LOGTAG = "AlsaAudioBackend: ";
+  // Frames written at a time, 20 ms at 16 kHz, so a stop is noticed quickly
+  static constexpr std::size_t kChunkFrames = 320;
+  // Period to check for a stop while the device plays the audio
+  static constexpr uint64_t kDrainPeriodUs = 20000;
+  static constexpr const char * kMixerCard = "default";
+  static constexpr const char * kMixerControl = "Master";
+
+  std::string device_;
+  // Only one buffer is sent at a time
+  std::mutex mutex_;
+  _snd_pcm * pcm_;
+  uint32_t sample_rate_;
+  uint16_t channels_;
+};
+
+#endif  // SPEECHAGENT__ALSA_AUDIO_BACKEND_HPP_
@@ -0,0 +1,163 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__AUDIO_BACKEND_HPP_
+#define SPEECHAGENT__AUDIO_BACKEND_HPP_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "speechAgent/audio_buffer.hpp"
+
+/**
+ * @brief Audio output where the sounds and the speech are played, and whose master
+ * volume is controlled. The last volume set is kept, so the device is only changed when
+ * the volume is different.
+ */
+class AudioBackend
+{
+public:
+  // Range of the master volume, in percent
+  static constexpr int kMinVolume = 0;
+  static constexpr int kMaxVolume = 100;
+  // Audio buffered by the devices, so the audio sent is heard within this time
+  static constexpr unsigned int kLatencyUs = 100000;
+
+  /**
+   * @brief Destroy the Audio Backend object.
+   */
+  virtual ~AudioBackend() = default;
+
+  AudioBackend(const AudioBackend &) = delete;
+  AudioBackend & operator=(const AudioBackend &) = delete;
+
+  /**
+   * @brief Play the audio and wait until it is played or stopped.
+   *
+   * @param buffer The audio.
+   * @param cancel Flag of the caller that also stops the audio, if not null.
+   * @return true If the whole audio was played.
+   */
+  bool play(const audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr);
+
+  /**
+   * @brief Send the audio to the device without waiting until it is played, so the next
+   * buffer follows it without a gap.
+   *
+   * @param buffer The audio.
+   * @param cancel Flag of the caller that also stops the audio, if not null.
+   * @return true If the whole audio was sent.
+   */
+  virtual bool write(const audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr) = 0;
+
+  /**
+   * @brief Wait until the audio sent is played or stopped.
+   *
+   * @param cancel Flag of the caller that also stops the audio, if not null.
+   * @return true If the audio was played until the end.
+   */
+  virtual bool drain(const std::atomic<bool> * cancel = nullptr) = 0;
+
+  /**
+   * @brief Stop the audio being played. It can be called from any thread.
+   */
+  void stop();
+
+  /**
+   * @brief Set the master volume. Nothing is done if it is the last volume set, so a
+   * change made by another program is not undone.
+   *
+   * @param percent The volume, clamped to [kMinVolume, kMaxVolume].
+   * @return true If the volume is set.
+   */
+  bool setVolume(int percent);
+
+  /**
+   * @brief Raise or lower the master volume.
+   *
+   * @param delta The change of the volume in percent, negative to lower it.
+   * @return true If the volume is set.
+   */
+  bool changeVolume(int delta);
+
+  /**
+   * @brief Get the master volume.
+   *
+   * @return int The last volume set or, if none was set, the volume of the device.
+   * Negative if it can't be read.
+   */
+  int volume();
+
+protected:
+  /**
+   * @brief Construct a new Audio Backend object.
+   */
+  AudioBackend();
+
+  /**
+   * @brief Set the master volume of the device.
+   *
+   * @param percent The volume in [kMinVolume, kMaxVolume].
+   * @return true If the volume was set.
+   */
+  virtual bool applyVolume(int percent) = 0;
+
+  /**
+   * @brief Read the master volume of the device.
+   *
+   * @return int The volume in percent, negative if it can't be read.
+   */
+  virtual int readVolume() = 0;
+
+  /**
+   * @brief Check if the audio must be stopped.
+   *
+   * @param cancel Flag of the caller, if not null.
+   * @return true If the audio must be stopped.
+   */
+  bool stopped(const std::atomic<bool> * cancel) const;
+
+  // Set by stop, it is cleared by write when the next audio starts
+  std::atomic<bool> stop_;
+
+private:
+  /**
+   * @brief Set the master volume if it is not the last one set. The volume mutex is locked.
+   *
+   * @param percent The volume.
+   * @return true If the volume is set.
+   */
+  bool updateVolume(int percent);
+
+  std::mutex volume_mutex_;
+  // Last volume set, negative if it is unknown
+  int volume_;
+};
+
+/**
+ * @brief Create an audio backend.
+ *
+ * @param type The backend: pulse (the default if empty), alsa, wav or null.
+ * @param name The name of the stream, the application name in PulseAudio and the
+ * file name of the WAV backend.
+ * @param device The ALSA device (default if empty) or the directory of the WAV files.
+ * @return std::unique_ptr<AudioBackend> The backend, null if the type is unknown.
+ */
+std::unique_ptr<AudioBackend> createAudioBackend(
+  const std::string & type, const std::string & name, const std::string & device);
+
+#endif  // SPEECHAGENT__AUDIO_BACKEND_HPP_
@@ -0,0 +1,30 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__AUDIO_BUFFER_HPP_
+#define SPEECHAGENT__AUDIO_BUFFER_HPP_
+
+#include <cstdint>
+#include <vector>
+
+// Signed 16 bits PCM audio. The samples of the channels are interleaved
+struct audioBuffer
+{
+  uint32_t sample_rate = 16000;
+  uint16_t channels = 1;
+  std::vector<int16_t> samples;
+};
+
+#endif  // SPEECHAGENT__AUDIO_BUFFER_HPP_
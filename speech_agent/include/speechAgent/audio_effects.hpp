@@ -0,0 +1,53 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__AUDIO_EFFECTS_HPP_
+#define SPEECHAGENT__AUDIO_EFFECTS_HPP_
+
+#include "speechAgent/audio_buffer.hpp"
+
+/**
+ * @brief Boost or cut the treble with a shelving filter, like the 'treble' effect of sox.
+ *
+ * @param buffer The audio, modified in place.
+ * @param gain_db The gain of the high frequencies in dB.
+ * @param frequency The center frequency of the shelf in Hz.
+ * @param slope The slope of the shelf, in (0, 1].
+ */
+void applyTreble(
+  audioBuffer & buffer, double gain_db, double frequency = 3000.0, double slope = 0.5);
+
+/**
+ * @brief Change the volume of the audio, like the 'gain' effect of sox.
+ * With the limiter the peaks are compressed smoothly instead of clipped.
+ *
+ * @param buffer The audio, modified in place.
+ * @param gain_db The gain in dB.
+ * @param limiter If the limiter is used.
+ */
+void applyGain(audioBuffer & buffer, double gain_db, bool limiter = false);
+
+/**
+ * @brief Convert the audio to another sample rate and number of channels. The samples
+ * are interpolated linearly, the mono audio is copied to all the channels and the
+ * audio with several channels is averaged to mono.
+ *
+ * @param buffer The audio, modified in place.
+ * @param sample_rate The new sample rate.
+ * @param channels The new number of channels.
+ */
+void convertFormat(audioBuffer & buffer, uint32_t sample_rate, uint16_t channels);
+
+#endif  // SPEECHAGENT__AUDIO_EFFECTS_HPP_
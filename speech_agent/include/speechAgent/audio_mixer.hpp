@@ -0,0 +1,171 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__AUDIO_MIXER_HPP_
+#define SPEECHAGENT__AUDIO_MIXER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "speechAgent/audio_backend.hpp"
+
+/**
+ * @brief Mixer of several streams of audio into one audio backend, so a sound can be
+ * played over the speech. The backend is opened once and written from the thread of the
+ * mixer. Each stream has its own gain, and the streams that duck lower the rest while
+ * they play, so they are heard over them.
+ */
+class AudioMixer
+{
+public:
+  // Format of the audio written to the backend. The streams are converted to it
+  static constexpr uint32_t kSampleRate = 48000;
+  static constexpr uint16_t kChannels = 2;
+
+  /**
+   * @brief Construct a new Audio Mixer object and start its thread.
+   *
+   * @param backend The backend where the mix is played.
+   * @param ducking_db The gain in dB of the streams lowered by the ducking streams.
+   */
+  AudioMixer(std::unique_ptr<AudioBackend> backend, double ducking_db);
+
+  /**
+   * @brief Destroy the Audio Mixer object. Stop the thread. The streams must be
+   * destroyed before.
+   */
+  ~AudioMixer();
+
+  AudioMixer(const AudioMixer &) = delete;
+  AudioMixer & operator=(const AudioMixer &) = delete;
+
+  /**
+   * @brief Create a stream of the mixer.
+   *
+   * @param gain_db The gain of the stream in dB.
+   * @param ducks If the rest of the streams are lowered while this one plays.
+   * @return std::unique_ptr<AudioBackend> The stream, used like the output of a backend.
+   */
+  std::unique_ptr<AudioBackend> createStream(double gain_db, bool ducks);
+
+private:
+  friend class MixerStream;
+
+  // Audio of a stream waiting to be mixed, already in the format of the mixer
+  struct streamState
+  {
+    double gain = 1.0;
+    bool ducks = false;
+    // Current gain of the ducking, moved smoothly towards the target
+    double ducking = 1.0;
+    std::deque<int16_t> samples;
+    // Frame of the mix with the last sample of the stream
+    uint64_t end_frame = 0;
+  };
+
+  /**
+   * @brief Main loop of the thread. Mix a period of the streams with audio and write it.
+   */
+  void run();
+
+  /**
+   * @brief Mix a period of the streams. The mutex is locked.
+   *
+   * @param period The mix, with kPeriodFrames frames.
+   */
+  void mix(std::vector<int16_t> & period);
+
+  /**
+   * @brief Check if a stream has audio waiting to be mixed. The mutex is locked.
+   *
+   * @return true If a stream has audio.
+   */
+  bool pending() const;
+
+  // Frames mixed at a time, 20 ms, so a stream waits at most that long to be heard
+  static constexpr std::size_t kPeriodFrames = kSampleRate / 50;
+  // Frames that a stream can queue before its writes wait, so a stop is quick
+  static constexpr std::size_t kMaxQueuedFrames = kSampleRate / 5;
+  // Frames written after the last sample of a stream until it is heard
+  static constexpr uint64_t kLatencyFrames =
+    static_cast<uint64_t>(kSampleRate) * AudioBackend::kLatencyUs / 1000000;
+  // Time to reach the gain of the ducking, to avoid clicks
+  static constexpr std::size_t kDuckingRampFrames = kSampleRate / 20;
+
+  std::unique_ptr<AudioBackend> backend_;
+  double ducking_gain_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::shared_ptr<streamState>> streams_;
+  // Frames mixed since the start, and the value when the backend was last drained
+  uint64_t mixed_frames_;
+  uint64_t drained_frames_;
+  bool running_;
+  std::thread thread_;
+};
+
+/**
+ * @brief Stream of an audio mixer. The audio written is queued until the mixer plays it,
+ * and the master volume is the volume of the backend of the mixer.
+ */
+class MixerStream : public AudioBackend
+{
+public:
+  /**
+   * @brief Destroy the Mixer Stream object. Its audio is discarded.
+   */
+  ~MixerStream() override;
+
+  bool write(const audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr) override;
+
+  bool drain(const std::atomic<bool> * cancel = nullptr) override;
+
+protected:
+  bool applyVolume(int percent) override;
+
+  int readVolume() override;
+
+private:
+  friend class AudioMixer;
+
+  /**
+   * @brief Construct a new Mixer Stream object. It is created by the mixer.
+   *
+   * @param mixer The mixer.
+   * @param state The audio of the stream, shared with the mixer.
+   */
+  MixerStream(AudioMixer & mixer, std::shared_ptr<AudioMixer::streamState> state);
+
+  /**
+   * @brief Discard the audio not mixed yet. The mutex of the mixer is locked.
+   */
+  void discard();
+
+  // Period to check for a stop while the audio waits to be mixed
+  static constexpr std::chrono::milliseconds kStopPeriod{20};
+
+  AudioMixer & mixer_;
+  std::shared_ptr<AudioMixer::streamState> state_;
+};
+
+#endif  // SPEECHAGENT__AUDIO_MIXER_HPP_
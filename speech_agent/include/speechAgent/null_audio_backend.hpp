@@ -0,0 +1,49 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__NULL_AUDIO_BACKEND_HPP_
+#define SPEECHAGENT__NULL_AUDIO_BACKEND_HPP_
+
+#include <atomic>
+
+#include "speechAgent/audio_backend.hpp"
+
+/**
+ * @brief Output that discards the audio at once, for the tests and the benchmarks
+ * without a sound card. The volume is only kept.
+ */
+class NullAudioBackend : public AudioBackend
+{
+public:
+  /**
+   * @brief Construct a new Null Audio Backend object.
+   */
+  NullAudioBackend() = default;
+
+  bool write(const audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr) override;
+
+  bool drain(const std::atomic<bool> * cancel = nullptr) override;
+
+protected:
+  bool applyVolume(int percent) override;
+
+  int readVolume() override;
+
+private:
+  // Volume reported before any is set
+  static constexpr int kDefaultVolume = 100;
+};
+
+#endif  // SPEECHAGENT__NULL_AUDIO_BACKEND_HPP_
@@ -0,0 +1,79 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__PLAYBACK_WORKER_HPP_
+#define SPEECHAGENT__PLAYBACK_WORKER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Thread that plays one action at a time, so the caller never waits for the audio.
+ * The playback is stopped with the stop functions of the audio outputs, which make the job
+ * return early.
+ */
+class PlaybackWorker
+{
+public:
+  // Function that plays the audio until it ends or is stopped
+  using playbackJob = std::function<bool ()>;
+  // Function called from the thread when the job ends, with the result of the job
+  using doneCallback = std::function<void (bool)>;
+
+  /**
+   * @brief Construct a new Playback Worker object and start the thread.
+   */
+  PlaybackWorker();
+
+  /**
+   * @brief Destroy the Playback Worker object. Wait for the current job and stop the thread.
+   */
+  ~PlaybackWorker();
+
+  /**
+   * @brief Start a job if there isn't another one running.
+   *
+   * @param job The job.
+   * @param on_done The function called when the job ends.
+   * @return true If the job was started.
+   */
+  bool start(playbackJob job, doneCallback on_done);
+
+  /**
+   * @brief Check if a job is running.
+   *
+   * @return true If a job is running.
+   */
+  bool busy() const;
+
+private:
+  /**
+   * @brief Main loop of the thread.
+   */
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  playbackJob job_;
+  doneCallback on_done_;
+  std::atomic<bool> busy_;
+  bool running_;
+  std::thread thread_;
+};
+
+#endif  // SPEECHAGENT__PLAYBACK_WORKER_HPP_
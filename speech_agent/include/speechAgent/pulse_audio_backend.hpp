@@ -0,0 +1,104 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__PULSE_AUDIO_BACKEND_HPP_
+#define SPEECHAGENT__PULSE_AUDIO_BACKEND_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "speechAgent/audio_backend.hpp"
+
+struct pa_simple;
+struct pa_threaded_mainloop;
+struct pa_context;
+
+/**
+ * @brief Playback stream of PulseAudio. The stream is kept open between buffers with
+ * the same format, so the audio is written to the server without spawning a player.
+ * The master volume is the volume of the first sink, changed through a connection to
+ * the server opened the first time, instead of running pactl.
+ */
+class PulseAudioBackend : public AudioBackend
+{
+public:
+  /**
+   * @brief Construct a new Pulse Audio Backend object.
+   *
+   * @param name The name of the application in the PulseAudio server.
+   */
+  explicit PulseAudioBackend(std::string name);
+
+  /**
+   * @brief Destroy the Pulse Audio Backend object. Close the stream and the connection.
+   */
+  ~PulseAudioBackend() override;
+
+  bool write(const audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr) override;
+
+  bool drain(const std::atomic<bool> * cancel = nullptr) override;
+
+protected:
+  bool applyVolume(int percent) override;
+
+  int readVolume() override;
+
+private:
+  /**
+   * @brief Open the stream with the format of the audio, if it is not open yet.
+   *
+   * @param buffer The audio.
+   * @return true If the stream is open.
+   */
+  bool open(const audioBuffer & buffer);
+
+  /**
+   * @brief Close the stream.
+   */
+  void close();
+
+  /**
+   * @brief Connect to the server to control the volume, if it is not connected yet.
+   *
+   * @return true If the connection is ready.
+   */
+  bool connect();
+
+  /**
+   * @brief Close the connection used to control the volume.
+   */
+  void disconnect();
+
+  static constexpr const char * LOGTAG = "PulseAudioBackend: ";
+  // Samples written at a time, 20 ms at 16 kHz, so a stop is noticed quickly
+  static constexpr std::size_t kChunkSamples = 320;
+  // Period to check for a stop while the server plays the audio
+  static constexpr uint64_t kDrainPeriodUs = 20000;
+  // Sink whose volume is the master volume, the same as 'pactl set-sink-volume 0'
+  static constexpr uint32_t kSinkIndex = 0;
+
+  std::string name_;
+  // Only one buffer is sent at a time
+  std::mutex mutex_;
+  pa_simple * stream_;
+  uint32_t sample_rate_;
+  uint16_t channels_;
+  // Connection to the server, used from the volume functions only
+  pa_threaded_mainloop * mainloop_;
+  pa_context * context_;
+};
+
+#endif  // SPEECHAGENT__PULSE_AUDIO_BACKEND_HPP_
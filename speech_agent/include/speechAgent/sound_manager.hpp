@@ -16,11 +16,19 @@
 #ifndef SOUND_MANAGER_HPP_
 #define SOUND_MANAGER_HPP_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+
+#include "speechAgent/audio_backend.hpp"
+#include "speechAgent/audio_buffer.hpp"
 
 
 // Initial implementation to managee sound settings and play sound
-// TODO: Use proper libraries, not system calls
+// The sounds are decoded once and played from memory
+// The master volume is set by the audio backend, only when it changes
 class SoundManager
 {
 
@@ -34,11 +42,13 @@ public:
   bool setMasterVolume(const int & percent);
   bool setMasterVolumeUp(const int & percent);
   bool setMasterVolumeDown(const int & percent);
+  void configOutput(std::unique_ptr<AudioBackend> backend);             // Set before anything is played
 
 
   // Multimedia functions
+  std::size_t loadSounds(const std::string & directory);                // Decode all the WAV files of the directory
   bool playFile(const std::string & file, const double & volumeFactor = 1);
-  bool playFileAndWait(const std::string & file, const double & volumeFactor = 1);
+  bool playFileAndWait(const std::string & file, const double & volumeFactor = 1, const std::atomic<bool> * cancel = nullptr);
 
   bool stop();
 
@@ -52,11 +62,14 @@ private:
   // Constants
 
   // Variables
+  std::mutex soundsMutex;
+  std::unordered_map<std::string, std::shared_ptr<const audioBuffer>> sounds;   // Sounds decoded, by path
+  std::unique_ptr<AudioBackend> output;                                           // Stream of the sounds and master volume
 
   // Functions
 
-  // Helper functions
-  bool runCommand(const std::string & command);
+  // Functions
+  std::shared_ptr<const audioBuffer> getSound(const std::string & file);
 };
 
 #endif  // SOUND_MANAGER_HPP_
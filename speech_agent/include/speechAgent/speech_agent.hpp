@@ -17,6 +17,8 @@
 #ifndef SPEECHAGENT__SPEECH_AGENT_HPP_
 #define SPEECHAGENT__SPEECH_AGENT_HPP_
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -37,8 +39,13 @@
 #include "dsr/api/dsr_api.h"
 #include "dsr/gui/dsr_gui.h"
 
+#include "speechAgent/action_queue.hpp"
+#include "speechAgent/audio_mixer.hpp"
+#include "speechAgent/playback_worker.hpp"
 #include "speechAgent/sound_manager.hpp"
 #include "speechAgent/speech_dispatcher.hpp"
+#include "speechAgent/synthesis_pipeline.hpp"
+#include "../../../include/async_logger.hpp"
 
 class SpeechAgent : public QObject
 {
@@ -63,16 +70,57 @@ public:
    * @brief Initialize the logger.
    *
    * @param log_filepath The path to the log file.
+   * @param params The parameters of the loggers.
    */
-  void initializeLogger(std::string log_filepath);
+  void initializeLogger(
+    std::string log_filepath, const loggerParameters & params = loggerParameters());
+
+  /**
+   * @brief Initialize the audio output of the speech and the sounds, mixed in one stream.
+   *
+   * @param backend The audio backend: pulse, alsa, wav or null. Empty for pulse.
+   * @param device The ALSA device or the directory of the WAV files.
+   * @param ducking_db The gain in dB of the speech while a sound is played over it.
+   * @return true If the backend is known. Otherwise PulseAudio is kept.
+   */
+  bool initializeAudio(std::string backend, std::string device, double ducking_db);
 
   /**
    * @brief Initialize the speech agent.
    *
    * @param sounds_filepath The path to the sounds file.
    * @param volume_factor The volume factor.
+   * @param pico_lang_path The directory of the Pico voices.
+   * @param pico_language The language of the Pico voice.
+   * @param lookahead The number of queued texts synthesized while another one is played.
+   */
+  void initializeSpeech(
+    std::string sounds_filepath, int volume_factor, std::string pico_lang_path,
+    std::string pico_language, std::size_t lookahead);
+
+  /**
+   * @brief Initialize the cache of the audio synthesized.
+   *
+   * @param memory_size The maximum size in bytes of the audio kept in memory.
+   * @param disk_path The directory of the audio kept on disk. Empty to disable it.
+   * @param disk_size The maximum size in bytes of the audio kept on disk.
+   */
+  void initializeSpeechCache(std::size_t memory_size, std::string disk_path, std::size_t disk_size);
+
+  /**
+   * @brief Set the difference of priority needed to interrupt the current action.
+   *
+   * @param threshold The difference of priority. 0 disables the interruptions.
+   */
+  void setPreemptionThreshold(int threshold);
+
+  /**
+   * @brief Set if the 'play' actions are performed over the 'say' action being performed,
+   * instead of waiting for it.
+   *
+   * @param enabled If the sounds are played over the speech.
    */
-  void initializeSpeech(std::string sounds_filepath, int volume_factor);
+  void setSoundsOverSpeech(bool enabled);
 
 public slots:
   /**
@@ -94,9 +142,70 @@ private:
   /**
    * @brief Set finished in the DSR.
    *
+   * @param action The action performed, reset if the event was set.
    * @return true If the event was set.
    */
-  bool setFinishedInDSR();
+  bool setFinishedInDSR(std::optional<queuedAction> & action);
+
+  /**
+   * @brief Perform an action in the playback thread. When it ends, actionPlayed is called
+   * from the Qt thread.
+   *
+   * @param id The id of the action.
+   * @param aborted Flag set when the action is aborted, checked by the job before playing.
+   * @param job The job that plays the action.
+   */
+  void startPlayback(
+    uint64_t id, std::shared_ptr<std::atomic<bool>> aborted, PlaybackWorker::playbackJob job);
+
+  /**
+   * @brief Finish the action played, if it is still the current one, and start the next one.
+   * A preempted action keeps its id when it is started again, so the playback is identified
+   * by its abort flag.
+   *
+   * @param id The id of the action.
+   * @param aborted The abort flag of the playback.
+   * @param success If the action was played until the end.
+   */
+  void actionPlayed(uint64_t id, std::shared_ptr<std::atomic<bool>> aborted, bool success);
+
+  /**
+   * @brief Stop the audio of the current action. The playback thread returns as soon as
+   * the audio stops.
+   */
+  void stopPlayback();
+
+  /**
+   * @brief Play the first 'play' action of the list over the 'say' action being performed,
+   * if no other sound is being played over it.
+   */
+  void startSoundOverSpeech();
+
+  /**
+   * @brief Finish the sound played over the speech, if it was not aborted.
+   *
+   * @param id The id of the action.
+   * @param aborted The abort flag of the playback.
+   * @param success If the sound was played until the end.
+   */
+  void soundOverSpeechPlayed(
+    uint64_t id, std::shared_ptr<std::atomic<bool>> aborted, bool success);
+
+  /**
+   * @brief Stop the sound played over the speech.
+   */
+  void stopSoundOverSpeech();
+
+  /**
+   * @brief Interrupt the current action and queue it again, so it is performed
+   * from the beginning when its turn comes.
+   */
+  void preemptCurrentAction();
+
+  /**
+   * @brief Synthesize in advance the texts of the next 'say' actions of the list.
+   */
+  void prefetchSpeech();
 
   // DSR graph
   std::shared_ptr<DSR::DSRGraph> G_;
@@ -104,24 +213,41 @@ private:
   std::string robot_name_;
 
   // Logger
-  std::shared_ptr<spdlog::sinks::stdout_color_sink_mt> console_sink_;
-  std::shared_ptr<spdlog::sinks::basic_file_sink_mt> debug_file_sink_;
-  std::unique_ptr<spdlog::logger> logger_;
+  spdlog::sink_ptr console_sink_;
+  spdlog::sink_ptr debug_file_sink_;
+  std::shared_ptr<spdlog::logger> logger_;
 
   // Speed related
+  // Declared before the dispatcher and the sound manager, so it outlives their streams
+  std::unique_ptr<AudioMixer> mixer_;
   SpeechDispatcher speech_;
   SoundManager sound_;
   std::string sounds_filepath_;
   int volume_factor_;
+  std::size_t lookahead_;
+  // Declared after speech_, so its thread stops before the dispatcher is destroyed
+  SynthesisPipeline pipeline_;
 
   QTimer timer_;
 
-  // Vector containing all 'say' and 'play' actions for the agent
-  std::vector<uint64_t> actions_list_;
+  // Queue of the 'say' and 'play' actions for the agent, by priority and arrival
+  ActionQueue actions_;
   // Action being currently performed
-  std::optional<uint64_t> current_action_;
+  std::optional<queuedAction> current_action_;
+  // Sound being played over the current 'say' action
+  std::optional<queuedAction> sound_action_;
+  bool sounds_over_speech_;
+  // Difference of priority needed to interrupt the current action, 0 to never interrupt it
+  int preemption_threshold_;
   // Id of the person node that is "interacting" the robot
   std::optional<uint64_t> person_node_id_;
+
+  // Declared last, so their threads stop before the rest is destroyed
+  PlaybackWorker playback_;
+  std::shared_ptr<std::atomic<bool>> current_aborted_;
+  // Thread of the sounds played over the speech
+  PlaybackWorker sound_playback_;
+  std::shared_ptr<std::atomic<bool>> sound_aborted_;
 };
 
 #endif  // SPEECHAGENT__SPEECH_AGENT_HPP_
@@ -0,0 +1,180 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__SPEECH_CACHE_HPP_
+#define SPEECHAGENT__SPEECH_CACHE_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "speechAgent/audio_buffer.hpp"
+
+// Counters and sizes of the cache
+struct speechCacheStats
+{
+  uint64_t memory_hits = 0;
+  uint64_t disk_hits = 0;
+  uint64_t misses = 0;
+  std::size_t memory_bytes = 0;
+  std::size_t disk_bytes = 0;
+};
+
+/**
+ * @brief Cache of the audio synthesized, addressed by the hash of the text and the voice
+ * settings. The most recent audio is kept in memory and, if a directory is configured,
+ * every audio is also stored on disk, so it survives the restarts of the agent.
+ * Both tiers drop the least recently used audio when they are full.
+ */
+class SpeechCache
+{
+public:
+  /**
+   * @brief Construct a new Speech Cache object with the default size of the memory tier
+   * and without the disk tier.
+   */
+  SpeechCache();
+
+  /**
+   * @brief Set the limits of the cache. The audio on the directory is indexed.
+   *
+   * @param max_memory_size The maximum size in bytes of the memory tier. 0 disables it.
+   * @param disk_path The directory of the disk tier. Empty disables it.
+   * @param max_disk_size The maximum size in bytes of the disk tier.
+   */
+  void configure(std::size_t max_memory_size, std::string disk_path, std::size_t max_disk_size);
+
+  /**
+   * @brief Build the key of a text said with some voice settings.
+   *
+   * @param text The text.
+   * @param language The language of the voice.
+   * @param voice The name of the voice.
+   * @param rate The speech rate.
+   * @param pitch The pitch.
+   * @return std::string The key.
+   */
+  static std::string makeKey(
+    const std::string & text, const std::string & language, const std::string & voice, int rate,
+    int pitch);
+
+  /**
+   * @brief Get the audio of a key. The audio found on disk is moved to the memory tier.
+   *
+   * @param key The key.
+   * @param buffer The audio, if found.
+   * @return true If the audio was found.
+   */
+  bool get(const std::string & key, audioBuffer & buffer);
+
+  /**
+   * @brief Store the audio of a key.
+   *
+   * @param key The key.
+   * @param buffer The audio.
+   */
+  void put(const std::string & key, const audioBuffer & buffer);
+
+  /**
+   * @brief Get the counters and sizes of the cache.
+   *
+   * @return speechCacheStats The counters and sizes.
+   */
+  speechCacheStats stats() const;
+
+private:
+  struct memoryEntry
+  {
+    std::string key;
+    audioBuffer buffer;
+  };
+
+  struct diskEntry
+  {
+    uint64_t hash;
+    std::size_t size;
+  };
+
+  /**
+   * @brief Hash of a key, FNV-1a, stable between runs for the file names.
+   *
+   * @param key The key.
+   * @return uint64_t The hash.
+   */
+  static uint64_t hash(const std::string & key);
+
+  /**
+   * @brief Path of the file of a hash in the disk tier.
+   *
+   * @param key_hash The hash.
+   * @return std::filesystem::path The path.
+   */
+  std::filesystem::path diskFile(uint64_t key_hash) const;
+
+  /**
+   * @brief Insert the audio in the memory tier and evict the oldest ones if it is full.
+   *
+   * @param key_hash The hash of the key.
+   * @param key The key.
+   * @param buffer The audio.
+   */
+  void putMemory(uint64_t key_hash, const std::string & key, const audioBuffer & buffer);
+
+  /**
+   * @brief Read the audio of a key from the disk tier.
+   *
+   * @param key_hash The hash of the key.
+   * @param key The key, compared with the one stored to detect collisions.
+   * @param buffer The audio, if found.
+   * @return true If the audio was found.
+   */
+  bool readDisk(uint64_t key_hash, const std::string & key, audioBuffer & buffer);
+
+  /**
+   * @brief Write the audio to the disk tier and evict the oldest ones if it is full.
+   *
+   * @param key_hash The hash of the key.
+   * @param key The key.
+   * @param buffer The audio.
+   */
+  void writeDisk(uint64_t key_hash, const std::string & key, const audioBuffer & buffer);
+
+  /**
+   * @brief Index the files of the disk tier, from the oldest to the newest.
+   */
+  void indexDisk();
+
+  static constexpr const char * LOGTAG = "SpeechCache: ";
+  static constexpr std::size_t kDefaultMemorySize = 32 * 1024 * 1024;
+  // First bytes of the files of the disk tier
+  static constexpr uint32_t kFileMagic = 0x48435053;
+
+  mutable std::mutex mutex_;
+  std::size_t max_memory_size_;
+  std::filesystem::path disk_path_;
+  std::size_t max_disk_size_;
+
+  // Least recently used audio first
+  std::list<memoryEntry> memory_;
+  std::unordered_map<uint64_t, std::list<memoryEntry>::iterator> memory_index_;
+  std::list<diskEntry> disk_;
+  std::unordered_map<uint64_t, std::list<diskEntry>::iterator> disk_index_;
+  speechCacheStats stats_;
+};
+
+#endif  // SPEECHAGENT__SPEECH_CACHE_HPP_
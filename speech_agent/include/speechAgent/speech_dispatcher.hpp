@@ -16,10 +16,17 @@
 #ifndef SPEECH_DISPATCHER_HPP_
 #define SPEECH_DISPATCHER_HPP_
 
+#include <atomic>
+#include <memory>
 #include <string>
 
+#include "speechAgent/audio_backend.hpp"
+#include "speechAgent/speech_cache.hpp"
+#include "speechAgent/ssip_client.hpp"
+#include "speechAgent/tts_engine.hpp"
+
 // Initial implementation to use speech-dispatcher
-// TODO: Use proper libraries, not system calls
+// The texts are sent over one SSIP connection, kept open between them
 // TODO: Add more command line options and make it configurable
 class SpeechDispatcher
 {
@@ -33,6 +40,9 @@ public:
   bool say(const std::string & text);
   bool sayAndWait(const std::string & text);
   bool sayWithPicoAndWait(const std::string & text);                 // TODO FIXME: Temporary fix to make better sound. Put it into other class, it's not related to SpeechDispatcher
+  bool synthesizeWithPico(const std::string & text, audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr);
+  bool playWithPicoAndWait(audioBuffer buffer, const std::atomic<bool> * cancel = nullptr);
+  bool sayStreamingWithPicoAndWait(const std::string & text, const std::atomic<bool> * cancel = nullptr);     // Plays each sentence while the next ones are synthesized
 
   bool stopMessage();
   bool cancel();
@@ -43,12 +53,18 @@ public:
   void configLanguage(const std::string & str);
   void configVoiceType(const std::string & str);
   void configVoice(const std::string & str);
+  bool configPicoLanguage(const std::string & langPath, const std::string & str);
+  void configCache(const std::size_t & memorySize, const std::string & path, const std::size_t & diskSize);
+  void configOutput(std::unique_ptr<AudioBackend> backend);         // Set before anything is said
 
   bool configSpeechVolume(const int & value);
   bool configSpeechRate(const int & value);
   bool configPitch(const int & value);
   bool configPitchRange(const int & value);
 
+  // Cache functions
+  speechCacheStats cacheStats() const;
+
 protected:
 
 private:
@@ -63,16 +79,23 @@ private:
   std::string language;                                      // ISO code
   std::string voiceType;                                     // Preferred voice type (male1, male2, male3, female1, female2, female3, child_male, child_female)
   std::string voice;                                         // Synthesis voice
-  int volume = 100;                                          // [-100, 100], spd default 100
+  std::atomic<int> volume = 100;                             // [-100, 100], spd default 100, read while playing
   int rate = 0;                                              // [-100, 100], spd default 0
   int pitch = 0;                                             // [-100, 100], spd default 0
   int pitchRange = 0;                                        // [-100, 100], spd default 0
+  std::string picoLangPath = "/usr/share/pico/lang/";        // Directory of the Pico voices
+  std::string picoLanguage = "es-ES";                        // Language of the Pico voice
 
-  // Functions
-  std::string processConfigOptions();
+  SsipClient ssip;                                           // Connection to speech-dispatcher
 
-  // Helper functions
-  bool runCommand(const std::string & command);
+  // Pico synthesis in the process and its output
+  TtsEngine tts;
+  std::unique_ptr<AudioBackend> output;
+  SpeechCache cache;                                         // Audio already synthesized
+
+  // Functions
+  bool applyConfig();                                        // Send the settings changed to speech-dispatcher
+  void filterPico(audioBuffer & buffer);
 };
 
 #endif  // SPEECH_DISPATCHER_HPP_
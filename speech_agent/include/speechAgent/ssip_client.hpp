@@ -0,0 +1,179 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__SSIP_CLIENT_HPP_
+#define SPEECHAGENT__SSIP_CLIENT_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Reply of speech-dispatcher to a command
+struct ssipReply
+{
+  int code = 0;
+  std::vector<std::string> lines;
+};
+
+/**
+ * @brief Client of speech-dispatcher that talks SSIP over one Unix socket, kept open
+ * between the messages. The settings are only sent when they change and the end of
+ * each message is notified by the server, so nothing is spawned to say a text.
+ */
+class SsipClient
+{
+public:
+  /**
+   * @brief Construct a new Ssip Client object. It connects the first time it is used.
+   *
+   * @param name The name of the application in speech-dispatcher.
+   */
+  explicit SsipClient(std::string name);
+
+  /**
+   * @brief Destroy the Ssip Client object. Close the connection.
+   */
+  ~SsipClient();
+
+  SsipClient(const SsipClient &) = delete;
+  SsipClient & operator=(const SsipClient &) = delete;
+
+  /**
+   * @brief Change a setting of the messages, like RATE or LANGUAGE. Nothing is sent if
+   * the setting already has this value.
+   *
+   * @param setting The name of the setting in SSIP.
+   * @param value The value.
+   * @return true If the setting has the value.
+   */
+  bool set(const std::string & setting, const std::string & value);
+
+  /**
+   * @brief Queue a text to be said, without waiting until it is said.
+   *
+   * @param text The text in UTF-8.
+   * @param message_id The id given by the server to the message.
+   * @return true If the message was queued.
+   */
+  bool speak(const std::string & text, int & message_id);
+
+  /**
+   * @brief Wait until a message is said or discarded.
+   *
+   * @param message_id The id of the message.
+   * @return true If the message was said until the end.
+   */
+  bool waitUntilSpoken(int message_id);
+
+  /**
+   * @brief Stop the message being said. Nothing is sent if the client is not connected,
+   * as there is nothing being said.
+   *
+   * @return true If there is no message being said.
+   */
+  bool stop();
+
+  /**
+   * @brief Stop the message being said and discard the queued ones.
+   *
+   * @return true If there are no messages left.
+   */
+  bool cancel();
+
+private:
+  /**
+   * @brief Connect to the server, if it is not connected. The command mutex is locked.
+   *
+   * @return true If the client is connected.
+   */
+  bool connect();
+
+  /**
+   * @brief Close the connection. The command mutex is locked.
+   */
+  void disconnect();
+
+  /**
+   * @brief Check if the client is connected.
+   *
+   * @return true If the client is connected.
+   */
+  bool connected();
+
+  /**
+   * @brief Send a command and wait for its reply. The command mutex is locked.
+   *
+   * @param command The command, without the end of line.
+   * @param reply The reply of the server.
+   * @return true If the reply is a success.
+   */
+  bool send(const std::string & command, ssipReply & reply);
+
+  /**
+   * @brief Read the replies and the events of the server until the connection is closed.
+   * It runs in the reader thread.
+   *
+   * @param socket The socket of the connection.
+   */
+  void readMessages(int socket);
+
+  /**
+   * @brief Store a reply or an event read from the server.
+   *
+   * @param code The code of the reply or the event.
+   * @param lines The lines of the reply, without the code.
+   */
+  void handleMessage(int code, std::vector<std::string> lines);
+
+  /**
+   * @brief Get the path to the socket of the server.
+   *
+   * @return std::string The path, like the other clients of speech-dispatcher.
+   */
+  static std::string socketPath();
+
+  static constexpr const char * LOGTAG = "SsipClient: ";
+  // Maximum time waiting for a reply before closing the connection
+  static constexpr std::chrono::seconds kReplyTimeout{5};
+  // Messages finished whose end is kept until someone waits for it
+  static constexpr std::size_t kMaxFinished = 64;
+
+  std::string name_;
+
+  // Only one command is sent at a time
+  std::mutex command_mutex_;
+  int socket_;
+  std::thread reader_;
+  // Settings sent in this connection
+  std::map<std::string, std::string> settings_;
+
+  // State shared with the reader thread
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool connected_;
+  // Incremented each time the connection is closed, so the waits of old messages end
+  uint64_t connection_;
+  std::deque<ssipReply> replies_;
+  // Messages finished, by id, and if they were said until the end
+  std::map<int, bool> finished_;
+};
+
+#endif  // SPEECHAGENT__SSIP_CLIENT_HPP_
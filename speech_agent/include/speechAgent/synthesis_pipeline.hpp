@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__SYNTHESIS_PIPELINE_HPP_
+#define SPEECHAGENT__SYNTHESIS_PIPELINE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "speechAgent/audio_buffer.hpp"
+
+/**
+ * @brief Synthesize the texts of the next actions in a worker thread while the current
+ * one is played, so the audio is ready when its turn comes.
+ */
+class SynthesisPipeline
+{
+public:
+  using synthesizeFunction =
+    std::function<bool (const std::string &, audioBuffer &, const std::atomic<bool> *)>;
+
+  /**
+   * @brief Construct a new Synthesis Pipeline object and start the thread.
+   *
+   * @param synthesize The function that synthesizes a text. It is called from the thread
+   * and stops early when its cancel flag is set.
+   * @param lookahead The maximum number of texts synthesized in advance.
+   */
+  SynthesisPipeline(synthesizeFunction synthesize, std::size_t lookahead);
+
+  /**
+   * @brief Destroy the Synthesis Pipeline object. Stop the thread.
+   */
+  ~SynthesisPipeline();
+
+  /**
+   * @brief Change the maximum number of texts synthesized in advance.
+   *
+   * @param lookahead The maximum number of texts.
+   */
+  void setLookahead(std::size_t lookahead);
+
+  /**
+   * @brief Synthesize the text of an action in advance. It is ignored if the action was
+   * already requested or there are already as many requests as the lookahead.
+   *
+   * @param id The id of the action.
+   * @param text The text.
+   */
+  void request(uint64_t id, const std::string & text);
+
+  /**
+   * @brief Get the audio of an action if it is already synthesized. It never waits: if it
+   * is being synthesized, the synthesis is cancelled. The request is removed in any case,
+   * so if the audio is not ready the caller synthesizes the text itself.
+   *
+   * @param id The id of the action.
+   * @param buffer The audio, if it was synthesized.
+   * @return true If the audio was synthesized.
+   */
+  bool take(uint64_t id, audioBuffer & buffer);
+
+  /**
+   * @brief Drop the request of an action and its audio, if any. Its synthesis is cancelled.
+   *
+   * @param id The id of the action.
+   */
+  void discard(uint64_t id);
+
+  /**
+   * @brief Drop all the requests and their audio.
+   */
+  void clear();
+
+private:
+  enum class jobState {QUEUED, RUNNING, READY, FAILED};
+
+  struct job
+  {
+    uint64_t id;
+    std::string text;
+    jobState state;
+    // Dropped while it was synthesized, the thread erases it when it ends
+    bool discarded;
+    // Set when it is dropped, so the synthesis stops
+    std::shared_ptr<std::atomic<bool>> cancel;
+    audioBuffer buffer;
+  };
+
+  /**
+   * @brief Main loop of the thread.
+   */
+  void run();
+
+  /**
+   * @brief Find the job of an action that has not been discarded.
+   *
+   * @param id The id of the action.
+   * @return std::list<job>::iterator The job or the end of the list.
+   */
+  std::list<job>::iterator find(uint64_t id);
+
+  /**
+   * @brief Drop the jobs that match a condition. The ones being synthesized are only marked
+   * and cancelled. The mutex is locked.
+   *
+   * @param condition The condition.
+   */
+  void drop(const std::function<bool(const job &)> & condition);
+
+  synthesizeFunction synthesize_;
+  std::size_t lookahead_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Requests in order of arrival
+  std::list<job> jobs_;
+  bool running_;
+  std::thread thread_;
+};
+
+#endif  // SPEECHAGENT__SYNTHESIS_PIPELINE_HPP_
@@ -0,0 +1,34 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__TEXT_SPLITTER_HPP_
+#define SPEECHAGENT__TEXT_SPLITTER_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Split a text in sentences, so each one can be synthesized and played while the
+ * next ones are synthesized. A sentence ends with '.', '!', '?', ';', ':' or a new line
+ * followed by a space. Long sentences are also split after the commas, but only when the
+ * clause is long enough to keep a natural intonation.
+ *
+ * @param text The text.
+ * @param min_clause_length The minimum length of a clause ended by a comma.
+ * @return std::vector<std::string> The segments of the text, without the spaces around.
+ */
+std::vector<std::string> splitText(const std::string & text, std::size_t min_clause_length = 60);
+
+#endif  // SPEECHAGENT__TEXT_SPLITTER_HPP_
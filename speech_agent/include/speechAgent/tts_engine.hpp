@@ -0,0 +1,118 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__TTS_ENGINE_HPP_
+#define SPEECHAGENT__TTS_ENGINE_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// PICO
+#include <picoapi.h>
+
+#include "speechAgent/audio_buffer.hpp"
+
+/**
+ * @brief Text to speech engine that runs the Pico (svox) library in the process.
+ * The voice is loaded once and the text is synthesized into memory, without the
+ * pico2wave process and the temporary WAV file.
+ */
+class TtsEngine
+{
+public:
+  // Sample rate of the audio synthesized by Pico
+  static constexpr uint32_t kSampleRate = 16000;
+
+  /**
+   * @brief Construct a new Tts Engine object.
+   */
+  TtsEngine();
+
+  /**
+   * @brief Destroy the Tts Engine object. Release the voice and the Pico system.
+   */
+  ~TtsEngine();
+
+  TtsEngine(const TtsEngine &) = delete;
+  TtsEngine & operator=(const TtsEngine &) = delete;
+
+  /**
+   * @brief Load the voice of a language. The previous voice is released.
+   *
+   * @param lang_path The directory of the Pico language files.
+   * @param language The language of the voice (es-ES, en-US, en-GB, de-DE, fr-FR or it-IT).
+   * @return true If the voice was loaded.
+   */
+  bool initialize(const std::string & lang_path, const std::string & language);
+
+  /**
+   * @brief Check if a voice is loaded.
+   *
+   * @return true If a voice is loaded.
+   */
+  bool isInitialized() const;
+
+  /**
+   * @brief Get the name of the voice loaded.
+   *
+   * @return const std::string& The name of the voice, empty if there is no voice.
+   */
+  const std::string & voice() const;
+
+  /**
+   * @brief Synthesize a text. Only one text is synthesized at a time.
+   *
+   * @param text The text in UTF-8.
+   * @param buffer The buffer where the audio is stored.
+   * @param rate The speech rate in [-100, 100].
+   * @param pitch The pitch in [-100, 100].
+   * @param cancel Flag of the caller that stops the synthesis, if not null.
+   * @return true If the text was synthesized.
+   */
+  bool synthesize(
+    const std::string & text, audioBuffer & buffer, int rate = 0, int pitch = 0,
+    const std::atomic<bool> * cancel = nullptr);
+
+private:
+  /**
+   * @brief Release the voice and the Pico system.
+   */
+  void release();
+
+  /**
+   * @brief Print the message of a Pico status.
+   *
+   * @param what The operation that failed.
+   * @param status The status returned by Pico.
+   */
+  void printError(const std::string & what, pico_Status status);
+
+  static constexpr const char * LOGTAG = "TtsEngine: ";
+  // Memory given to the Pico system, the same as pico2wave
+  static constexpr std::size_t kMemorySize = 2500000;
+  static constexpr const char * kVoiceName = "PicoVoice";
+
+  std::mutex mutex_;
+  std::vector<char> memory_;
+  std::string voice_;
+  pico_System system_;
+  pico_Resource ta_resource_;
+  pico_Resource sg_resource_;
+  pico_Engine engine_;
+};
+
+#endif  // SPEECHAGENT__TTS_ENGINE_HPP_
@@ -0,0 +1,33 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__WAV_FILE_HPP_
+#define SPEECHAGENT__WAV_FILE_HPP_
+
+#include <string>
+
+#include "speechAgent/audio_buffer.hpp"
+
+/**
+ * @brief Read a WAV file and convert it to signed 16 bits PCM. The file can be PCM of
+ * 8, 16, 24 or 32 bits or float of 32 bits, with any sample rate and number of channels.
+ *
+ * @param filename The path to the file.
+ * @param buffer The audio.
+ * @return true If the file was read.
+ */
+bool readWav(const std::string & filename, audioBuffer & buffer);
+
+#endif  // SPEECHAGENT__WAV_FILE_HPP_
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPEECHAGENT__WAV_FILE_BACKEND_HPP_
+#define SPEECHAGENT__WAV_FILE_BACKEND_HPP_
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "speechAgent/audio_backend.hpp"
+
+/**
+ * @brief Output that records the audio in a WAV file instead of playing it, for the
+ * tests and the benchmarks without a sound card. The audio is written as fast as it
+ * comes and the file is started again if the format changes. The volume is only kept.
+ */
+class WavFileBackend : public AudioBackend
+{
+public:
+  /**
+   * @brief Construct a new Wav File Backend object.
+   *
+   * @param filename The path to the file, created the first time the audio is written.
+   */
+  explicit WavFileBackend(std::string filename);
+
+  /**
+   * @brief Destroy the Wav File Backend object. Complete the header and close the file.
+   */
+  ~WavFileBackend() override;
+
+  bool write(const audioBuffer & buffer, const std::atomic<bool> * cancel = nullptr) override;
+
+  bool drain(const std::atomic<bool> * cancel = nullptr) override;
+
+protected:
+  bool applyVolume(int percent) override;
+
+  int readVolume() override;
+
+private:
+  /**
+   * @brief Create the file with the format of the audio, if it is not open yet.
+   *
+   * @param buffer The audio.
+   * @return true If the file is open.
+   */
+  bool open(const audioBuffer & buffer);
+
+  /**
+   * @brief Complete the header and close the file.
+   */
+  void close();
+
+  /**
+   * @brief Write the header with the size of the audio written so far.
+   */
+  void writeHeader();
+
+  static constexpr const char * LOGTAG = "WavFileBackend: ";
+  // Volume reported before any is set
+  static constexpr int kDefaultVolume = 100;
+
+  std::string filename_;
+  std::mutex mutex_;
+  std::ofstream file_;
+  uint32_t sample_rate_;
+  uint16_t channels_;
+  // Size of the samples written
+  uint32_t data_size_;
+};
+
+#endif  // SPEECHAGENT__WAV_FILE_BACKEND_HPP_
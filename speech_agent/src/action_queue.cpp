@@ -0,0 +1,63 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "speechAgent/action_queue.hpp"
+
+ActionQueue::ActionQueue()
+: arrivals_(0)
+{
+}
+
+bool ActionQueue::push(uint64_t id, int priority)
+{
+  if (index_.contains(id)) {
+    return false;
+  }
+  index_[id] = actions_.insert(queuedAction{id, priority, arrivals_++}).first;
+  return true;
+}
+
+void ActionQueue::requeue(const queuedAction & action)
+{
+  remove(action.id);
+  index_[action.id] = actions_.insert(action).first;
+}
+
+std::optional<queuedAction> ActionQueue::pop()
+{
+  if (actions_.empty()) {
+    return std::nullopt;
+  }
+  queuedAction action = *actions_.begin();
+  index_.erase(action.id);
+  actions_.erase(actions_.begin());
+  return action;
+}
+
+bool ActionQueue::remove(uint64_t id)
+{
+  auto it = index_.find(id);
+  if (it == index_.end()) {
+    return false;
+  }
+  actions_.erase(it->second);
+  index_.erase(it);
+  return true;
+}
+
+bool ActionQueue::empty() const
+{
+  return actions_.empty();
+}
@@ -0,0 +1,207 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// ALSA
+#include <alsa/asoundlib.h>
+
+#include "speechAgent/alsa_audio_backend.hpp"
+
+AlsaAudioBackend::AlsaAudioBackend(std::string device)
+: device_(device), pcm_(nullptr), sample_rate_(0), channels_(0)
+{
+}
+
+AlsaAudioBackend::~AlsaAudioBackend()
+{
+  close();
+}
+
+bool AlsaAudioBackend::write(const audioBuffer & buffer, const std::atomic<bool> * cancel)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stop_ = false;
+  if (!open(buffer)) {
+    return false;
+  }
+
+  std::size_t frames = buffer.samples.size() / buffer.channels;
+  std::size_t frame = 0;
+  while (frame < frames) {
+    if (stopped(cancel)) {
+      discard();
+      return false;
+    }
+    snd_pcm_sframes_t written = snd_pcm_writei(
+      pcm_, &buffer.samples[frame * buffer.channels], std::min(kChunkFrames, frames - frame));
+    if (written < 0) {
+      // An underrun is recovered and the chunk is written again
+      int error = snd_pcm_recover(pcm_, static_cast<int>(written), 1);
+      if (error < 0) {
+        std::cerr << LOGTAG << "Cannot write the audio: " << snd_strerror(error) << std::endl;
+        close();
+        return false;
+      }
+      continue;
+    }
+    frame += static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+bool AlsaAudioBackend::drain(const std::atomic<bool> * cancel)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pcm_ == nullptr) {
+    return false;
+  }
+
+  // snd_pcm_drain can't be interrupted, so it is only called for the last milliseconds
+  while (!stopped(cancel)) {
+    snd_pcm_sframes_t delay = 0;
+    int error = snd_pcm_delay(pcm_, &delay);
+    if (error < 0) {
+      // After an underrun everything was played
+      if (snd_pcm_recover(pcm_, error, 1) < 0) {
+        std::cerr << LOGTAG << "Cannot get the delay: " << snd_strerror(error) << std::endl;
+        close();
+        return false;
+      }
+      return true;
+    }
+    if (static_cast<uint64_t>(std::max<snd_pcm_sframes_t>(delay, 0)) * 1000000 / sample_rate_ <=
+      kDrainPeriodUs)
+    {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(kDrainPeriodUs));
+  }
+  if (stopped(cancel)) {
+    discard();
+    return false;
+  }
+  int error = snd_pcm_drain(pcm_);
+  // The device must be prepared again after a drain
+  snd_pcm_prepare(pcm_);
+  if (error < 0) {
+    std::cerr << LOGTAG << "Cannot drain the audio: " << snd_strerror(error) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool AlsaAudioBackend::applyVolume(int percent)
+{
+  return withMasterControl(
+    [percent](snd_mixer_elem_t * control, long min, long max) {
+      return snd_mixer_selem_set_playback_volume_all(
+        control, min + (max - min) * percent / 100) >= 0;
+    });
+}
+
+int AlsaAudioBackend::readVolume()
+{
+  int percent = -1;
+  withMasterControl(
+    [&percent](snd_mixer_elem_t * control, long min, long max) {
+      long value = 0;
+      if (max <= min ||
+        snd_mixer_selem_get_playback_volume(control, SND_MIXER_SCHN_FRONT_LEFT, &value) < 0)
+      {
+        return false;
+      }
+      percent = static_cast<int>(((value - min) * 100 + (max - min) / 2) / (max - min));
+      return true;
+    });
+  return percent;
+}
+
+bool AlsaAudioBackend::open(const audioBuffer & buffer)
+{
+  if (pcm_ != nullptr && sample_rate_ == buffer.sample_rate && channels_ == buffer.channels) {
+    return true;
+  }
+  close();
+
+  int error = snd_pcm_open(&pcm_, device_.c_str(), SND_PCM_STREAM_PLAYBACK, 0);
+  if (error < 0) {
+    std::cerr << LOGTAG << "Cannot open the device " << device_ << ": " << snd_strerror(error) <<
+      std::endl;
+    pcm_ = nullptr;
+    return false;
+  }
+  // The device resamples the audio if it doesn't support its rate
+  error = snd_pcm_set_params(
+    pcm_, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED, buffer.channels,
+    buffer.sample_rate, 1, kLatencyUs);
+  if (error < 0) {
+    std::cerr << LOGTAG << "Cannot set the format: " << snd_strerror(error) << std::endl;
+    close();
+    return false;
+  }
+  sample_rate_ = buffer.sample_rate;
+  channels_ = buffer.channels;
+  return true;
+}
+
+void AlsaAudioBackend::close()
+{
+  if (pcm_ != nullptr) {
+    snd_pcm_close(pcm_);
+    pcm_ = nullptr;
+  }
+}
+
+void AlsaAudioBackend::discard()
+{
+  snd_pcm_drop(pcm_);
+  snd_pcm_prepare(pcm_);
+}
+
+template<typename Function>
+bool AlsaAudioBackend::withMasterControl(Function function)
+{
+  // The mixer is only opened when the volume changes, which is seldom
+  snd_mixer_t * mixer = nullptr;
+  if (snd_mixer_open(&mixer, 0) < 0) {
+    std::cerr << LOGTAG << "Cannot open the mixer" << std::endl;
+    return false;
+  }
+  snd_mixer_selem_id_t * id = nullptr;
+  bool done = false;
+  if (snd_mixer_attach(mixer, kMixerCard) >= 0 &&
+    snd_mixer_selem_register(mixer, nullptr, nullptr) >= 0 && snd_mixer_load(mixer) >= 0 &&
+    snd_mixer_selem_id_malloc(&id) >= 0)
+  {
+    snd_mixer_selem_id_set_index(id, 0);
+    snd_mixer_selem_id_set_name(id, kMixerControl);
+    snd_mixer_elem_t * control = snd_mixer_find_selem(mixer, id);
+    long min = 0, max = 0;
+    done = control != nullptr &&
+      snd_mixer_selem_get_playback_volume_range(control, &min, &max) >= 0 &&
+      function(control, min, max);
+    snd_mixer_selem_id_free(id);
+  }
+  if (!done) {
+    std::cerr << LOGTAG << "Cannot use the control " << kMixerControl << " of the card " <<
+      kMixerCard << std::endl;
+  }
+  snd_mixer_close(mixer);
+  return done;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+#include "speechAgent/alsa_audio_backend.hpp"
+#include "speechAgent/audio_backend.hpp"
+#include "speechAgent/null_audio_backend.hpp"
+#include "speechAgent/pulse_audio_backend.hpp"
+#include "speechAgent/wav_file_backend.hpp"
+
+AudioBackend::AudioBackend()
+: stop_(false), volume_(-1)
+{
+}
+
+bool AudioBackend::play(const audioBuffer & buffer, const std::atomic<bool> * cancel)
+{
+  return write(buffer, cancel) && drain(cancel);
+}
+
+void AudioBackend::stop()
+{
+  stop_ = true;
+}
+
+bool AudioBackend::setVolume(int percent)
+{
+  std::lock_guard<std::mutex> lock(volume_mutex_);
+  return updateVolume(percent);
+}
+
+bool AudioBackend::changeVolume(int delta)
+{
+  std::lock_guard<std::mutex> lock(volume_mutex_);
+  if (volume_ < 0) {
+    volume_ = readVolume();
+    if (volume_ < 0) {
+      return false;
+    }
+  }
+  return updateVolume(volume_ + delta);
+}
+
+int AudioBackend::volume()
+{
+  std::lock_guard<std::mutex> lock(volume_mutex_);
+  if (volume_ < 0) {
+    volume_ = readVolume();
+  }
+  return volume_;
+}
+
+bool AudioBackend::stopped(const std::atomic<bool> * cancel) const
+{
+  return stop_ || (cancel != nullptr && *cancel);
+}
+
+bool AudioBackend::updateVolume(int percent)
+{
+  percent = std::clamp(percent, kMinVolume, kMaxVolume);
+  if (percent == volume_) {
+    return true;
+  }
+  if (!applyVolume(percent)) {
+    // The volume of the device is unknown after an error
+    volume_ = -1;
+    return false;
+  }
+  volume_ = percent;
+  return true;
+}
+
+std::unique_ptr<AudioBackend> createAudioBackend(
+  const std::string & type, const std::string & name, const std::string & device)
+{
+  if (type.empty() || type == "pulse") {
+    return std::make_unique<PulseAudioBackend>(name);
+  } else if (type == "alsa") {
+    return std::make_unique<AlsaAudioBackend>(device.empty() ? "default" : device);
+  } else if (type == "wav") {
+    auto filename = std::filesystem::path(device) / (name + ".wav");
+    return std::make_unique<WavFileBackend>(filename.string());
+  } else if (type == "null") {
+    return std::make_unique<NullAudioBackend>();
+  }
+  std::cerr << "AudioBackend: Unknown audio backend: " << type << std::endl;
+  return nullptr;
+}
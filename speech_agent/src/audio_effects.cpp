@@ -0,0 +1,124 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+#include "speechAgent/audio_effects.hpp"
+
+namespace
+{
+// Level where the limiter starts to compress, relative to full scale
+constexpr double kLimiterThreshold = 0.8;
+
+int16_t toSample(double value)
+{
+  return static_cast<int16_t>(std::clamp(std::lround(value), -32768L, 32767L));
+}
+}  // namespace
+
+void applyTreble(audioBuffer & buffer, double gain_db, double frequency, double slope)
+{
+  if (buffer.channels == 0 || buffer.sample_rate == 0) {
+    return;
+  }
+
+  // High shelf biquad of the Audio EQ Cookbook (R. Bristow-Johnson), as sox does
+  const double a = std::pow(10.0, gain_db / 40.0);
+  const double w0 = 2.0 * std::numbers::pi * frequency / buffer.sample_rate;
+  const double cos_w0 = std::cos(w0);
+  const double alpha = std::sin(w0) / 2.0 * std::sqrt((a + 1.0 / a) * (1.0 / slope - 1.0) + 2.0);
+  const double sqrt_a_alpha = 2.0 * std::sqrt(a) * alpha;
+
+  const double a0 = (a + 1.0) - (a - 1.0) * cos_w0 + sqrt_a_alpha;
+  const double b0 = a * ((a + 1.0) + (a - 1.0) * cos_w0 + sqrt_a_alpha) / a0;
+  const double b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cos_w0) / a0;
+  const double b2 = a * ((a + 1.0) + (a - 1.0) * cos_w0 - sqrt_a_alpha) / a0;
+  const double a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cos_w0) / a0;
+  const double a2 = ((a + 1.0) - (a - 1.0) * cos_w0 - sqrt_a_alpha) / a0;
+
+  // Direct form I, with the state of each channel
+  struct filterState {double x1 = 0, x2 = 0, y1 = 0, y2 = 0;};
+  std::vector<filterState> states(buffer.channels);
+  for (std::size_t i = 0; i < buffer.samples.size(); ++i) {
+    auto & s = states[i % buffer.channels];
+    double x = buffer.samples[i];
+    double y = b0 * x + b1 * s.x1 + b2 * s.x2 - a1 * s.y1 - a2 * s.y2;
+    s.x2 = s.x1;
+    s.x1 = x;
+    s.y2 = s.y1;
+    s.y1 = y;
+    buffer.samples[i] = toSample(y);
+  }
+}
+
+void applyGain(audioBuffer & buffer, double gain_db, bool limiter)
+{
+  const double gain = std::pow(10.0, gain_db / 20.0);
+  for (auto & sample : buffer.samples) {
+    double value = sample * gain / 32768.0;
+    double level = std::abs(value);
+    if (limiter && level > kLimiterThreshold) {
+      // Soft knee from the threshold up to the full scale
+      level = kLimiterThreshold + (1.0 - kLimiterThreshold) *
+        std::tanh((level - kLimiterThreshold) / (1.0 - kLimiterThreshold));
+      value = std::copysign(level, value);
+    }
+    sample = toSample(value * 32768.0);
+  }
+}
+
+void convertFormat(audioBuffer & buffer, uint32_t sample_rate, uint16_t channels)
+{
+  if (buffer.channels == 0 || buffer.sample_rate == 0 || sample_rate == 0 || channels == 0 ||
+    (buffer.sample_rate == sample_rate && buffer.channels == channels))
+  {
+    return;
+  }
+
+  const std::size_t frames = buffer.samples.size() / buffer.channels;
+  const std::size_t new_frames = frames * sample_rate / buffer.sample_rate;
+  const double step = static_cast<double>(buffer.sample_rate) / sample_rate;
+  // Sample of a channel in the original audio, the average of all of them for mono
+  auto sample = [&](std::size_t frame, uint16_t channel) {
+      const int16_t * data = &buffer.samples[frame * buffer.channels];
+      if (channels == 1 && buffer.channels > 1) {
+        double sum = 0;
+        for (uint16_t c = 0; c < buffer.channels; ++c) {
+          sum += data[c];
+        }
+        return sum / buffer.channels;
+      }
+      return static_cast<double>(data[std::min<uint16_t>(channel, buffer.channels - 1)]);
+    };
+
+  std::vector<int16_t> samples(new_frames * channels);
+  for (std::size_t i = 0; i < new_frames; ++i) {
+    double position = i * step;
+    std::size_t frame = static_cast<std::size_t>(position);
+    std::size_t next = std::min(frame + 1, frames - 1);
+    double fraction = position - frame;
+    for (uint16_t c = 0; c < channels; ++c) {
+      samples[i * channels + c] =
+        toSample(sample(frame, c) * (1.0 - fraction) + sample(next, c) * fraction);
+    }
+  }
+  buffer.sample_rate = sample_rate;
+  buffer.channels = channels;
+  buffer.samples = std::move(samples);
+}
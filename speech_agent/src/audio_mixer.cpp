@@ -0,0 +1,203 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "speechAgent/audio_effects.hpp"
+#include "speechAgent/audio_mixer.hpp"
+
+AudioMixer::AudioMixer(std::unique_ptr<AudioBackend> backend, double ducking_db)
+: backend_(std::move(backend)), ducking_gain_(std::pow(10.0, ducking_db / 20.0)),
+  mixed_frames_(0), drained_frames_(0), running_(true)
+{
+  thread_ = std::thread(&AudioMixer::run, this);
+}
+
+AudioMixer::~AudioMixer()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+std::unique_ptr<AudioBackend> AudioMixer::createStream(double gain_db, bool ducks)
+{
+  auto state = std::make_shared<streamState>();
+  state->gain = std::pow(10.0, gain_db / 20.0);
+  state->ducks = ducks;
+  std::lock_guard<std::mutex> lock(mutex_);
+  streams_.push_back(state);
+  return std::unique_ptr<AudioBackend>(new MixerStream(*this, state));
+}
+
+void AudioMixer::run()
+{
+  audioBuffer period;
+  period.sample_rate = kSampleRate;
+  period.channels = kChannels;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() {return pending() || !running_;});
+    if (!running_) {
+      break;
+    }
+    mix(period.samples);
+    // The streams waiting for room or for the end of their audio are woken up
+    cv_.notify_all();
+
+    // The backend paces the mixer, as it waits while its buffer is full
+    lock.unlock();
+    backend_->write(period);
+    lock.lock();
+    if (!pending()) {
+      // Nothing else to play, so the end of the audio is played instead of cut
+      uint64_t mixed = mixed_frames_;
+      lock.unlock();
+      backend_->drain();
+      lock.lock();
+      drained_frames_ = mixed;
+      cv_.notify_all();
+    }
+  }
+}
+
+void AudioMixer::mix(std::vector<int16_t> & period)
+{
+  std::vector<double> sum(kPeriodFrames * kChannels, 0.0);
+  bool ducking = std::any_of(
+    streams_.begin(), streams_.end(), [](const auto & stream) {
+      return stream->ducks && !stream->samples.empty();
+    });
+  const double ramp_step = std::abs(1.0 - ducking_gain_) / kDuckingRampFrames;
+
+  for (auto & stream : streams_) {
+    double target = ducking && !stream->ducks ? ducking_gain_ : 1.0;
+    if (stream->samples.empty()) {
+      stream->ducking = target;
+      continue;
+    }
+    std::size_t frames = std::min(kPeriodFrames, stream->samples.size() / kChannels);
+    for (std::size_t frame = 0; frame < frames; ++frame) {
+      stream->ducking += std::clamp(target - stream->ducking, -ramp_step, ramp_step);
+      double gain = stream->gain * stream->ducking;
+      for (std::size_t i = frame * kChannels; i < (frame + 1) * kChannels; ++i) {
+        sum[i] += stream->samples[i] * gain;
+      }
+    }
+    stream->samples.erase(stream->samples.begin(), stream->samples.begin() + frames * kChannels);
+    if (stream->samples.empty()) {
+      stream->end_frame = mixed_frames_ + frames;
+    }
+  }
+
+  period.resize(sum.size());
+  for (std::size_t i = 0; i < sum.size(); ++i) {
+    period[i] = static_cast<int16_t>(std::clamp(std::lround(sum[i]), -32768L, 32767L));
+  }
+  mixed_frames_ += kPeriodFrames;
+}
+
+bool AudioMixer::pending() const
+{
+  return std::any_of(
+    streams_.begin(), streams_.end(), [](const auto & stream) {
+      return !stream->samples.empty();
+    });
+}
+
+MixerStream::MixerStream(AudioMixer & mixer, std::shared_ptr<AudioMixer::streamState> state)
+: mixer_(mixer), state_(state)
+{
+}
+
+MixerStream::~MixerStream()
+{
+  std::lock_guard<std::mutex> lock(mixer_.mutex_);
+  auto & streams = mixer_.streams_;
+  streams.erase(std::remove(streams.begin(), streams.end(), state_), streams.end());
+}
+
+bool MixerStream::write(const audioBuffer & buffer, const std::atomic<bool> * cancel)
+{
+  stop_ = false;
+  // The audio is converted out of the lock, so the mixer is not delayed
+  const audioBuffer * source = &buffer;
+  audioBuffer converted;
+  if (buffer.sample_rate != AudioMixer::kSampleRate || buffer.channels != AudioMixer::kChannels) {
+    converted = buffer;
+    convertFormat(converted, AudioMixer::kSampleRate, AudioMixer::kChannels);
+    source = &converted;
+  }
+
+  std::unique_lock<std::mutex> lock(mixer_.mutex_);
+  const std::size_t max_samples = AudioMixer::kMaxQueuedFrames * AudioMixer::kChannels;
+  std::size_t written = 0;
+  while (written < source->samples.size()) {
+    if (stopped(cancel)) {
+      discard();
+      return false;
+    }
+    if (state_->samples.size() >= max_samples) {
+      mixer_.cv_.wait_for(lock, kStopPeriod);
+      continue;
+    }
+    std::size_t count =
+      std::min(max_samples - state_->samples.size(), source->samples.size() - written);
+    auto begin = source->samples.begin() + written;
+    state_->samples.insert(state_->samples.end(), begin, begin + count);
+    written += count;
+    mixer_.cv_.notify_all();
+  }
+  return true;
+}
+
+bool MixerStream::drain(const std::atomic<bool> * cancel)
+{
+  std::unique_lock<std::mutex> lock(mixer_.mutex_);
+  while (true) {
+    if (stopped(cancel)) {
+      discard();
+      return false;
+    }
+    // The last sample is heard once the backend is drained or after its latency
+    if (state_->samples.empty() &&
+      (mixer_.drained_frames_ >= state_->end_frame ||
+      mixer_.mixed_frames_ >= state_->end_frame + AudioMixer::kLatencyFrames))
+    {
+      return true;
+    }
+    mixer_.cv_.wait_for(lock, kStopPeriod);
+  }
+}
+
+bool MixerStream::applyVolume(int percent)
+{
+  return mixer_.backend_->setVolume(percent);
+}
+
+int MixerStream::readVolume()
+{
+  return mixer_.backend_->volume();
+}
+
+void MixerStream::discard()
+{
+  state_->samples.clear();
+  mixer_.cv_.notify_all();
+}
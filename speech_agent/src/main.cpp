@@ -79,6 +79,17 @@ int main(int argc, char * argv[])
   auto log_path = config["log_path"];
   auto sounds_filepath = config["sounds_filepath"];
   auto volume_factor = config["volume_factor"];
+  auto audio_backend = config["audio_backend"];
+  auto audio_device = config["audio_device"];
+  auto audio_ducking_db = config["audio_ducking_db"];
+  auto sounds_over_speech = config["sounds_over_speech"];
+  auto pico_lang_path = config["pico_lang_path"];
+  auto pico_language = config["pico_language"];
+  auto speech_lookahead = config["speech_lookahead"];
+  auto preemption_threshold = config["preemption_threshold"];
+  auto cache_memory_size = config["speech_cache_memory_size"];
+  auto cache_path = config["speech_cache_path"];
+  auto cache_disk_size = config["speech_cache_disk_size"];
 
   std::cout << "Configuration parameters for the episodicAgent:" << std::endl;
   std::cout << "Agent name: " << agent_name << std::endl;
@@ -87,8 +98,18 @@ int main(int argc, char * argv[])
   std::cout << "Log path: " << log_path << std::endl;
 
   auto speech_agent = SpeechAgent(agent_name, agent_id, robot_name);
-  speech_agent.initializeLogger(log_path);
-  speech_agent.initializeSpeech(sounds_filepath, std::stoi(volume_factor));
+  speech_agent.initializeLogger(log_path, loggerParametersFromConfig(config));
+  speech_agent.initializeAudio(
+    audio_backend, audio_device, audio_ducking_db.empty() ? -12.0 : std::stod(audio_ducking_db));
+  speech_agent.initializeSpeech(
+    sounds_filepath, std::stoi(volume_factor), pico_lang_path, pico_language,
+    speech_lookahead.empty() ? 2 : std::stoul(speech_lookahead));
+  speech_agent.setPreemptionThreshold(
+    preemption_threshold.empty() ? 0 : std::stoi(preemption_threshold));
+  speech_agent.setSoundsOverSpeech(sounds_over_speech == "true");
+  speech_agent.initializeSpeechCache(
+    cache_memory_size.empty() ? 32 * 1024 * 1024 : std::stoul(cache_memory_size), cache_path,
+    cache_disk_size.empty() ? 0 : std::stoul(cache_disk_size));
 
   return app.exec();
 }
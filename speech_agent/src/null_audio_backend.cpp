@@ -0,0 +1,37 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "speechAgent/null_audio_backend.hpp"
+
+bool NullAudioBackend::write(const audioBuffer &, const std::atomic<bool> * cancel)
+{
+  stop_ = false;
+  return !stopped(cancel);
+}
+
+bool NullAudioBackend::drain(const std::atomic<bool> * cancel)
+{
+  return !stopped(cancel);
+}
+
+bool NullAudioBackend::applyVolume(int)
+{
+  return true;
+}
+
+int NullAudioBackend::readVolume()
+{
+  return kDefaultVolume;
+}
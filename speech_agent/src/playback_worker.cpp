@@ -0,0 +1,77 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "speechAgent/playback_worker.hpp"
+
+PlaybackWorker::PlaybackWorker()
+: busy_(false), running_(true)
+{
+  thread_ = std::thread(&PlaybackWorker::run, this);
+}
+
+PlaybackWorker::~PlaybackWorker()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool PlaybackWorker::start(playbackJob job, doneCallback on_done)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (busy_) {
+      return false;
+    }
+    job_ = std::move(job);
+    on_done_ = std::move(on_done);
+    busy_ = true;
+  }
+  cv_.notify_one();
+  return true;
+}
+
+bool PlaybackWorker::busy() const
+{
+  return busy_;
+}
+
+void PlaybackWorker::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] {return !running_ || job_;});
+    if (!running_) {
+      break;
+    }
+    auto job = std::move(job_);
+    auto on_done = std::move(on_done_);
+    job_ = nullptr;
+    lock.unlock();
+
+    bool success = job();
+    // A new job can be started from the callback
+    busy_ = false;
+    if (on_done) {
+      on_done(success);
+    }
+    lock.lock();
+  }
+}
@@ -0,0 +1,303 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// PULSEAUDIO
+#include <pulse/pulseaudio.h>
+#include <pulse/simple.h>
+#include <pulse/error.h>
+
+#include "speechAgent/pulse_audio_backend.hpp"
+
+namespace
+{
+// Result of a request to the server, filled in the thread of the main loop
+struct sinkRequest
+{
+  pa_threaded_mainloop * mainloop;
+  bool found = false;
+  bool success = false;
+  uint8_t channels = 0;
+  pa_volume_t volume = 0;
+};
+
+void contextStateCallback(pa_context *, void * userdata)
+{
+  pa_threaded_mainloop_signal(static_cast<pa_threaded_mainloop *>(userdata), 0);
+}
+
+void sinkInfoCallback(pa_context *, const pa_sink_info * info, int eol, void * userdata)
+{
+  auto request = static_cast<sinkRequest *>(userdata);
+  if (eol == 0 && info != nullptr) {
+    request->found = true;
+    request->channels = info->channel_map.channels;
+    request->volume = pa_cvolume_avg(&info->volume);
+  }
+  pa_threaded_mainloop_signal(request->mainloop, 0);
+}
+
+void successCallback(pa_context *, int success, void * userdata)
+{
+  auto request = static_cast<sinkRequest *>(userdata);
+  request->success = success != 0;
+  pa_threaded_mainloop_signal(request->mainloop, 0);
+}
+
+// Wait until the operation ends. The main loop must be locked
+bool waitOperation(pa_threaded_mainloop * mainloop, pa_operation * operation)
+{
+  if (operation == nullptr) {
+    return false;
+  }
+  while (pa_operation_get_state(operation) == PA_OPERATION_RUNNING) {
+    pa_threaded_mainloop_wait(mainloop);
+  }
+  bool done = pa_operation_get_state(operation) == PA_OPERATION_DONE;
+  pa_operation_unref(operation);
+  return done;
+}
+}  // namespace
+
+PulseAudioBackend::PulseAudioBackend(std::string name)
+: name_(name), stream_(nullptr), sample_rate_(0), channels_(0), mainloop_(nullptr),
+  context_(nullptr)
+{
+}
+
+PulseAudioBackend::~PulseAudioBackend()
+{
+  close();
+  disconnect();
+}
+
+bool PulseAudioBackend::write(const audioBuffer & buffer, const std::atomic<bool> * cancel)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stop_ = false;
+  if (!open(buffer)) {
+    return false;
+  }
+
+  int error = 0;
+  std::size_t chunk = kChunkSamples * buffer.channels;
+  for (std::size_t i = 0; i < buffer.samples.size(); i += chunk) {
+    if (stopped(cancel)) {
+      // Discard the audio already sent to the server
+      pa_simple_flush(stream_, &error);
+      return false;
+    }
+    std::size_t samples = std::min(chunk, buffer.samples.size() - i);
+    if (pa_simple_write(stream_, &buffer.samples[i], samples * sizeof(int16_t), &error) < 0) {
+      std::cerr << LOGTAG << "Cannot write the audio: " << pa_strerror(error) << std::endl;
+      close();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PulseAudioBackend::drain(const std::atomic<bool> * cancel)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stream_ == nullptr) {
+    return false;
+  }
+
+  // pa_simple_drain can't be interrupted, so it is only called for the last milliseconds
+  int error = 0;
+  while (!stopped(cancel)) {
+    pa_usec_t latency = pa_simple_get_latency(stream_, &error);
+    if (latency == static_cast<pa_usec_t>(-1)) {
+      std::cerr << LOGTAG << "Cannot get the latency: " << pa_strerror(error) << std::endl;
+      close();
+      return false;
+    }
+    if (latency <= kDrainPeriodUs) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(kDrainPeriodUs));
+  }
+  if (stopped(cancel)) {
+    pa_simple_flush(stream_, &error);
+    return false;
+  }
+  if (pa_simple_drain(stream_, &error) < 0) {
+    std::cerr << LOGTAG << "Cannot drain the audio: " << pa_strerror(error) << std::endl;
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool PulseAudioBackend::applyVolume(int percent)
+{
+  if (!connect()) {
+    return false;
+  }
+  pa_threaded_mainloop_lock(mainloop_);
+  // The volume is set in all the channels of the sink, like pactl does
+  sinkRequest request{mainloop_};
+  bool done = waitOperation(
+    mainloop_,
+    pa_context_get_sink_info_by_index(context_, kSinkIndex, sinkInfoCallback, &request)) &&
+    request.found;
+  if (done) {
+    pa_cvolume volume;
+    pa_cvolume_set(
+      &volume, request.channels, static_cast<pa_volume_t>(PA_VOLUME_NORM * percent / 100));
+    done = waitOperation(
+      mainloop_,
+      pa_context_set_sink_volume_by_index(
+        context_, kSinkIndex, &volume, successCallback, &request)) && request.success;
+  }
+  if (!done) {
+    std::cerr << LOGTAG << "Cannot set the volume of the sink " << kSinkIndex << ": " <<
+      pa_strerror(pa_context_errno(context_)) << std::endl;
+  }
+  pa_threaded_mainloop_unlock(mainloop_);
+  return done;
+}
+
+int PulseAudioBackend::readVolume()
+{
+  if (!connect()) {
+    return -1;
+  }
+  pa_threaded_mainloop_lock(mainloop_);
+  sinkRequest request{mainloop_};
+  bool done = waitOperation(
+    mainloop_,
+    pa_context_get_sink_info_by_index(context_, kSinkIndex, sinkInfoCallback, &request)) &&
+    request.found;
+  pa_threaded_mainloop_unlock(mainloop_);
+  if (!done) {
+    std::cerr << LOGTAG << "Cannot read the volume of the sink " << kSinkIndex << std::endl;
+    return -1;
+  }
+  return static_cast<int>((static_cast<uint64_t>(request.volume) * 100 + PA_VOLUME_NORM / 2) /
+         PA_VOLUME_NORM);
+}
+
+bool PulseAudioBackend::open(const audioBuffer & buffer)
+{
+  if (stream_ != nullptr && sample_rate_ == buffer.sample_rate && channels_ == buffer.channels) {
+    return true;
+  }
+  close();
+
+  pa_sample_spec spec;
+  spec.format = PA_SAMPLE_S16LE;
+  spec.rate = buffer.sample_rate;
+  spec.channels = static_cast<uint8_t>(buffer.channels);
+  // The server buffers kLatencyUs instead of its default of 2 s, so the audio written
+  // after another one is heard soon
+  pa_buffer_attr attributes;
+  attributes.maxlength = static_cast<uint32_t>(-1);
+  attributes.tlength = static_cast<uint32_t>(pa_usec_to_bytes(kLatencyUs, &spec));
+  attributes.prebuf = static_cast<uint32_t>(-1);
+  attributes.minreq = static_cast<uint32_t>(-1);
+  attributes.fragsize = static_cast<uint32_t>(-1);
+  int error = 0;
+  stream_ = pa_simple_new(
+    nullptr, name_.c_str(), PA_STREAM_PLAYBACK, nullptr, "playback", &spec, nullptr,
+    &attributes, &error);
+  if (stream_ == nullptr) {
+    std::cerr << LOGTAG << "Cannot open the stream: " << pa_strerror(error) << std::endl;
+    return false;
+  }
+  sample_rate_ = buffer.sample_rate;
+  channels_ = buffer.channels;
+  return true;
+}
+
+void PulseAudioBackend::close()
+{
+  if (stream_ != nullptr) {
+    pa_simple_free(stream_);
+    stream_ = nullptr;
+  }
+}
+
+bool PulseAudioBackend::connect()
+{
+  if (context_ != nullptr) {
+    pa_threaded_mainloop_lock(mainloop_);
+    bool ready = pa_context_get_state(context_) == PA_CONTEXT_READY;
+    pa_threaded_mainloop_unlock(mainloop_);
+    if (ready) {
+      return true;
+    }
+    // The server was restarted, so connect again
+    disconnect();
+  }
+
+  mainloop_ = pa_threaded_mainloop_new();
+  if (mainloop_ == nullptr) {
+    std::cerr << LOGTAG << "Cannot create the main loop" << std::endl;
+    return false;
+  }
+  context_ = pa_context_new(pa_threaded_mainloop_get_api(mainloop_), name_.c_str());
+  if (context_ == nullptr) {
+    std::cerr << LOGTAG << "Cannot create the context" << std::endl;
+    disconnect();
+    return false;
+  }
+  pa_context_set_state_callback(context_, contextStateCallback, mainloop_);
+
+  pa_threaded_mainloop_lock(mainloop_);
+  bool ready = pa_context_connect(context_, nullptr, PA_CONTEXT_NOFLAGS, nullptr) >= 0 &&
+    pa_threaded_mainloop_start(mainloop_) >= 0;
+  while (ready) {
+    pa_context_state_t state = pa_context_get_state(context_);
+    if (state == PA_CONTEXT_READY) {
+      break;
+    }
+    if (!PA_CONTEXT_IS_GOOD(state)) {
+      ready = false;
+      break;
+    }
+    pa_threaded_mainloop_wait(mainloop_);
+  }
+  if (!ready) {
+    std::cerr << LOGTAG << "Cannot connect to the server: " <<
+      pa_strerror(pa_context_errno(context_)) << std::endl;
+  }
+  pa_threaded_mainloop_unlock(mainloop_);
+  if (!ready) {
+    disconnect();
+  }
+  return ready;
+}
+
+void PulseAudioBackend::disconnect()
+{
+  if (mainloop_ != nullptr) {
+    pa_threaded_mainloop_stop(mainloop_);
+  }
+  if (context_ != nullptr) {
+    pa_context_disconnect(context_);
+    pa_context_unref(context_);
+    context_ = nullptr;
+  }
+  if (mainloop_ != nullptr) {
+    pa_threaded_mainloop_free(mainloop_);
+    mainloop_ = nullptr;
+  }
+}
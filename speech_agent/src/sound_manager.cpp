@@ -14,13 +14,17 @@
 // limitations under the License.
 
 #include <algorithm>
-#include <cstdlib>
+#include <cmath>
+#include <filesystem>
 #include <iostream>
 
+#include "speechAgent/audio_effects.hpp"
 #include "speechAgent/sound_manager.hpp"
+#include "speechAgent/wav_file.hpp"
 
 // Functions
 SoundManager::SoundManager()
+: output(createAudioBackend("pulse", "soundManager", ""))
 {
   // Initialize variables
 }
@@ -34,7 +38,7 @@ SoundManager::~SoundManager()
 bool SoundManager::setMasterVolume(const int & percent)
 {
   if (DEBUG) {std::cout << LOGTAG << "Setting master volume to " << percent << "%" << std::endl;}
-  return runCommand("pactl -- set-sink-volume 0 " + std::to_string(percent) + "%");
+  return output->setVolume(percent);
 }
 
 bool SoundManager::setMasterVolumeUp(const int & percent)
@@ -42,7 +46,7 @@ bool SoundManager::setMasterVolumeUp(const int & percent)
   if (DEBUG) {
     std::cout << LOGTAG << "Setting master volume to " << percent << "% higher" << std::endl;
   }
-  return runCommand("pactl -- set-sink-volume 0 +" + std::to_string(percent) + "%");
+  return output->changeVolume(percent);
 }
 
 bool SoundManager::setMasterVolumeDown(const int & percent)
@@ -50,41 +54,78 @@ bool SoundManager::setMasterVolumeDown(const int & percent)
   if (DEBUG) {
     std::cout << LOGTAG << "Setting master volume to " << percent << "% lower" << std::endl;
   }
-  return runCommand("pactl -- set-sink-volume 0 -" + std::to_string(percent) + "%");
+  return output->changeVolume(-percent);
+}
+
+void SoundManager::configOutput(std::unique_ptr<AudioBackend> backend)
+{
+  if (DEBUG) {std::cout << LOGTAG << "Setting audio output" << std::endl;}
+  output = std::move(backend);
 }
 
 // Multimedia functions
-bool SoundManager::playFile(const std::string & file, const double & volumeFactor)
+std::size_t SoundManager::loadSounds(const std::string & directory)
 {
-  if (file.empty()) {
-    std::cout << "WARNING: Could not play an empty file" << std::endl;
+  if (DEBUG) {std::cout << LOGTAG << "Loading sounds from \"" << directory << "\"" << std::endl;}
+  std::size_t loaded = 0;
+  std::error_code error;
+  for (const auto & entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".wav") {
+      loaded += getSound(entry.path().string()) ? 1 : 0;
+    }
   }
-  if (DEBUG) {std::cout << LOGTAG << "Playing file \"" << file << "\"" << std::endl;}
-  std::string volumeFactorS = std::to_string(volumeFactor);
-  std::replace(volumeFactorS.begin(), volumeFactorS.end(), ',', '.');
-  return runCommand("play -q -v " + volumeFactorS + " \"" + file + "\" -t alsa");
+  if (error) {
+    std::cout << "WARNING: Could not read the sounds directory " << directory << ": " <<
+      error.message() << std::endl;
+  }
+  return loaded;
 }
 
-bool SoundManager::playFileAndWait(const std::string & file, const double & volumeFactor)
+bool SoundManager::playFile(const std::string & file, const double & volumeFactor)
+{
+  return playFileAndWait(file, volumeFactor);
+}
+
+bool SoundManager::playFileAndWait(
+  const std::string & file, const double & volumeFactor, const std::atomic<bool> * cancel)
 {
   if (file.empty()) {
     std::cout << "WARNING: Could not play an empty file" << std::endl;
   }
   if (DEBUG) {std::cout << LOGTAG << "Playing file \"" << file << "\"" << std::endl;}
-  std::string volumeFactorS = std::to_string(volumeFactor);
-  std::replace(volumeFactorS.begin(), volumeFactorS.end(), ',', '.');
-  return runCommand("play -q -v " + volumeFactorS + " \"" + file + "\" -t alsa");
+  auto sound = getSound(file);
+  if (!sound) {
+    std::cout << "WARNING: Could not read the file " << file << std::endl;
+    return false;
+  }
+  // The decoded sound is shared, so it is only copied to change its volume
+  if (volumeFactor == 1) {
+    return output->play(*sound, cancel);
+  }
+  audioBuffer buffer = *sound;
+  applyGain(buffer, 20.0 * std::log10(std::max(volumeFactor, 1e-5)));
+  return output->play(buffer, cancel);
 }
 
 bool SoundManager::stop()
 {
   if (DEBUG) {std::cout << LOGTAG << "Stopping sound" << std::endl;}
-  return runCommand("pkill play");
+  output->stop();
+  return true;
 }
 
-// Helpers
-bool SoundManager::runCommand(const std::string & command)
+std::shared_ptr<const audioBuffer> SoundManager::getSound(const std::string & file)
 {
-  if (DEBUG) {std::cout << LOGTAG << "Running command: '" << command << "'" << std::endl;}
-  return std::system(command.c_str()) == 0;
+  std::string path = std::filesystem::path(file).lexically_normal().string();
+  std::lock_guard<std::mutex> lock(soundsMutex);
+  if (auto it = sounds.find(path); it != sounds.end()) {
+    return it->second;
+  }
+  // Sounds added after the start are decoded the first time they are played
+  auto sound = std::make_shared<audioBuffer>();
+  if (!readWav(path, *sound)) {
+    return nullptr;
+  }
+  sounds[path] = sound;
+  return sound;
 }
@@ -14,12 +14,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 
 #include "speechAgent/speech_agent.hpp"
 #include "../../include/dsr_api_ext.hpp"
 
 SpeechAgent::SpeechAgent(std::string agent_name, int agent_id, std::string robot_name)
-: agent_name_(agent_name), robot_name_(robot_name)
+: agent_name_(agent_name), robot_name_(robot_name), volume_factor_(1), lookahead_(2),
+  pipeline_(
+    [this](const std::string & text, audioBuffer & buffer, const std::atomic<bool> * cancel) {
+      return speech_.synthesizeWithPico(text, buffer, cancel);
+    }, lookahead_),
+  sounds_over_speech_(false), preemption_threshold_(0)
 {
   // Compute
   QObject::connect(&timer_, SIGNAL(timeout()), this, SLOT(compute()));
@@ -52,43 +58,93 @@ SpeechAgent::SpeechAgent(std::string agent_name, int agent_id, std::string robot
 
 SpeechAgent::~SpeechAgent()
 {
+  // Don't wait for the audio being played
+  stopPlayback();
+  stopSoundOverSpeech();
   G_.reset();
   logger_->info("Destroying SpeechAgent");
 }
 
-void SpeechAgent::initializeLogger(std::string log_filepath)
+void SpeechAgent::initializeLogger(std::string log_filepath, const loggerParameters & params)
 {
   // Initialize logger
   std::string log_folder = log_filepath + std::to_string(std::time(nullptr)) + "/" + agent_name_;
   std::string debug_log_file = log_folder + "/debug.log";
-  console_sink_ = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-  debug_file_sink_ = std::make_shared<spdlog::sinks::basic_file_sink_mt>(debug_log_file, true);
-  logger_ = std::make_unique<spdlog::logger>(
-    agent_name_, spdlog::sinks_init_list{console_sink_, debug_file_sink_});
-  debug_file_sink_->set_level(spdlog::level::debug);
-  logger_->set_level(spdlog::level::debug);
+  console_sink_ = createConsoleSink(params);
+  debug_file_sink_ = createFileSink(debug_log_file, params);
+  logger_ = createAsyncLogger(agent_name_, {console_sink_, debug_file_sink_}, params);
 
   logger_->info("Initialize speech agent");
 }
 
-void SpeechAgent::initializeSpeech(std::string sounds_filepath, int volume_factor)
+bool SpeechAgent::initializeAudio(std::string backend, std::string device, double ducking_db)
+{
+  // The speech and the sounds are mixed in one stream, opened once
+  auto output = createAudioBackend(backend, agent_name_, device);
+  if (!output) {
+    logger_->error("Unknown audio backend {}, using PulseAudio", backend);
+    return false;
+  }
+  auto mixer = std::make_unique<AudioMixer>(std::move(output), ducking_db);
+  // The sounds lower the speech while they are played over it
+  speech_.configOutput(mixer->createStream(0.0, false));
+  sound_.configOutput(mixer->createStream(0.0, true));
+  // The previous mixer is destroyed after its streams
+  mixer_ = std::move(mixer);
+  logger_->info(
+    "Playing the audio with the {} backend, ducking the speech {} dB",
+    backend.empty() ? "pulse" : backend, ducking_db);
+  return true;
+}
+
+void SpeechAgent::initializeSpeech(
+  std::string sounds_filepath, int volume_factor, std::string pico_lang_path,
+  std::string pico_language, std::size_t lookahead)
 {
   sounds_filepath_ = sounds_filepath;
   volume_factor_ = volume_factor;
+  lookahead_ = lookahead;
+  pipeline_.setLookahead(lookahead_);
+  // Decode the sounds now, so the 'play' actions don't read the files
+  logger_->info("Loaded {} sounds from {}", sound_.loadSounds(sounds_filepath_), sounds_filepath_);
+  // Load the voice now, so the first 'say' doesn't wait for it
+  if (!speech_.configPicoLanguage(pico_lang_path, pico_language)) {
+    logger_->error("Cannot load the Pico voice {} from {}", pico_language, pico_lang_path);
+  }
   timer_.start(100);
 }
 
+void SpeechAgent::initializeSpeechCache(
+  std::size_t memory_size, std::string disk_path, std::size_t disk_size)
+{
+  speech_.configCache(memory_size, disk_path, disk_size);
+}
+
+void SpeechAgent::setPreemptionThreshold(int threshold)
+{
+  preemption_threshold_ = threshold;
+}
+
+void SpeechAgent::setSoundsOverSpeech(bool enabled)
+{
+  sounds_over_speech_ = enabled;
+}
+
 void SpeechAgent::compute()
 {
-  // Play the first action in the list if there is no action being performed
-  if (!actions_list_.empty() && !current_action_.has_value()) {
-    // Assign the first action of the list to be performed
-    current_action_ = actions_list_.front();
-    // Delete the action from the list
-    actions_list_.erase(actions_list_.begin());
+  // Play the first action in the list if there is no action being performed.
+  // An action aborted may still be stopping in the playback thread, and the next action
+  // waits for the sound played over the speech
+  if (!actions_.empty() && !current_action_.has_value() && !playback_.busy() &&
+    !sound_action_.has_value() && !sound_playback_.busy())
+  {
+    // Take the action with the highest priority
+    current_action_ = actions_.pop();
+    // Synthesize the next texts while this action is performed
+    prefetchSpeech();
     // Get the name of the action
-    auto action_node = G_->get_node(current_action_.value());
-    auto act_name = G_->get_name_from_id(current_action_.value());
+    auto action_node = G_->get_node(current_action_->id);
+    auto act_name = G_->get_name_from_id(current_action_->id);
     // Replace the 'wants_to' edge with a 'is_performing' edge between robot and action
     if (DSR::replace_edge<is_performing_edge_type>(
         G_, robot_name_, act_name.value(), "wants_to", robot_name_))
@@ -100,20 +156,36 @@ void SpeechAgent::compute()
       sound_.setMasterVolume(volume_to_change);
       speech_.configSpeechVolume(volume_to_change);
 
-      // Perform the action
+      // Perform the action in the playback thread
+      uint64_t id = current_action_->id;
+      auto aborted = std::make_shared<std::atomic<bool>>(false);
       if (act_name.value() == "say") {
         auto text = G_->get_attrib_by_name<text_att>(action_node.value());
         if (text.has_value()) {
-          speech_.sayWithPicoAndWait(text.value());
-          setFinishedInDSR();
+          startPlayback(
+            id, aborted, [this, id, aborted, text = text.value()]() {
+              // Synthesized in advance or, if not, played by sentences while synthesized
+              audioBuffer buffer;
+              bool success = pipeline_.take(id, buffer) ?
+              speech_.playWithPicoAndWait(std::move(buffer), aborted.get()) :
+              speech_.sayStreamingWithPicoAndWait(text, aborted.get());
+              auto stats = speech_.cacheStats();
+              logger_->debug(
+                "Speech cache: {} memory hits, {} disk hits, {} misses, {} bytes in memory, "
+                "{} bytes on disk", stats.memory_hits, stats.disk_hits, stats.misses,
+                stats.memory_bytes, stats.disk_bytes);
+              return success;
+            });
         } else {
           logger_->error("Error trying to say when the action is say");
         }
       } else if (act_name.value() == "play") {
         auto soundfile = G_->get_attrib_by_name<sound_att>(action_node.value());
         if (soundfile.has_value()) {
-          sound_.playFileAndWait(sounds_filepath_ + soundfile.value() + ".wav", volume_factor_);
-          setFinishedInDSR();
+          startPlayback(
+            id, aborted, [this, aborted, file = sounds_filepath_ + soundfile.value() + ".wav"]() {
+              return sound_.playFileAndWait(file, volume_factor_, aborted.get());
+            });
         } else {
           logger_->error("Error trying to play when the action is play");
         }
@@ -122,26 +194,173 @@ void SpeechAgent::compute()
       }
     }
   }
+  // The sounds queued don't wait for the speech
+  startSoundOverSpeech();
+}
+
+void SpeechAgent::startPlayback(
+  uint64_t id, std::shared_ptr<std::atomic<bool>> aborted, PlaybackWorker::playbackJob job)
+{
+  current_aborted_ = aborted;
+  playback_.start(
+    std::move(job), [this, id, aborted](bool success) {
+      // Back to the Qt thread, where the DSR and the list of actions are used
+      QMetaObject::invokeMethod(
+        this, [this, id, aborted, success]() {actionPlayed(id, aborted, success);},
+        Qt::QueuedConnection);
+    });
+}
+
+void SpeechAgent::actionPlayed(
+  uint64_t id, std::shared_ptr<std::atomic<bool>> aborted, bool success)
+{
+  // The action may have been aborted, cancelled or preempted and started again while it
+  // was played
+  if (current_action_.has_value() && aborted == current_aborted_) {
+    if (!success) {
+      logger_->warn("The action {} could not be played", id);
+    }
+    setFinishedInDSR(current_action_);
+  }
+  // Start the next action without waiting for the timer
+  if (!actions_.empty()) {
+    compute();
+  }
 }
 
-bool SpeechAgent::setFinishedInDSR()
+bool SpeechAgent::setFinishedInDSR(std::optional<queuedAction> & action)
 {
   bool success = false;
   // Check if the robot is currently performing an action
-  if (current_action_.has_value()) {
-    auto action = G_->get_name_from_id(current_action_.value());
-    // Replace the 'is_performing' edge with a 'finished' edge between robot and current_action
+  if (action.has_value()) {
+    auto action_name = G_->get_name_from_id(action->id);
+    // Replace the 'is_performing' edge with a 'finished' edge between robot and the action
     if (DSR::replace_edge<finished_edge_type>(
-        G_, robot_name_, action.value(), "is_performing", robot_name_))
+        G_, robot_name_, action_name.value(), "is_performing", robot_name_))
     {
-      current_action_.reset();
+      action.reset();
       success = true;
-      logger_->info("Finished action {}", action.value());
+      logger_->info("Finished action {}", action_name.value());
     }
   }
   return success;
 }
 
+void SpeechAgent::stopPlayback()
+{
+  if (current_aborted_) {
+    *current_aborted_ = true;
+  }
+  // The sound played over the speech goes on
+  if (!sound_action_.has_value()) {
+    sound_.stop();
+  }
+  speech_.stopMessage();
+}
+
+void SpeechAgent::startSoundOverSpeech()
+{
+  if (!sounds_over_speech_ || !current_action_.has_value() || sound_action_.has_value() ||
+    sound_playback_.busy() || G_->get_name_from_id(current_action_->id) != "say")
+  {
+    return;
+  }
+  // The first sound of the list, whatever its priority, as it doesn't delay the rest
+  auto sound = std::find_if(
+    actions_.begin(), actions_.end(), [this](const queuedAction & action) {
+      return G_->get_name_from_id(action.id) == "play";
+    });
+  if (sound == actions_.end()) {
+    return;
+  }
+  queuedAction action = *sound;
+  auto action_node = G_->get_node(action.id);
+  auto robot_node = G_->get_node(robot_name_);
+  if (!action_node.has_value() || !robot_node.has_value()) {
+    return;
+  }
+  // Without a sound it is left to compute, that reports the error
+  auto soundfile = G_->get_attrib_by_name<sound_att>(action_node.value());
+  if (!soundfile.has_value() ||
+    !DSR::replace_edge<is_performing_edge_type>(
+      G_, robot_node.value().id(), action.id, "wants_to", robot_name_))
+  {
+    return;
+  }
+  actions_.remove(action.id);
+  sound_action_ = action;
+  logger_->info("Playing the action {} over the speech", action.id);
+
+  auto aborted = std::make_shared<std::atomic<bool>>(false);
+  sound_aborted_ = aborted;
+  sound_playback_.start(
+    [this, aborted, file = sounds_filepath_ + soundfile.value() + ".wav"]() {
+      return sound_.playFileAndWait(file, volume_factor_, aborted.get());
+    },
+    [this, id = action.id, aborted](bool success) {
+      QMetaObject::invokeMethod(
+        this, [this, id, aborted, success]() {soundOverSpeechPlayed(id, aborted, success);},
+        Qt::QueuedConnection);
+    });
+}
+
+void SpeechAgent::soundOverSpeechPlayed(
+  uint64_t id, std::shared_ptr<std::atomic<bool>> aborted, bool success)
+{
+  // The sound may have been aborted or cancelled while it was played
+  if (sound_action_.has_value() && aborted == sound_aborted_) {
+    if (!success) {
+      logger_->warn("The action {} could not be played", id);
+    }
+    setFinishedInDSR(sound_action_);
+  }
+  // The actions waiting for the sound start now
+  compute();
+}
+
+void SpeechAgent::stopSoundOverSpeech()
+{
+  if (sound_aborted_) {
+    *sound_aborted_ = true;
+  }
+  sound_.stop();
+}
+
+void SpeechAgent::preemptCurrentAction()
+{
+  auto action = current_action_.value();
+  current_action_.reset();
+  stopPlayback();
+
+  // Back to 'wants_to', as if it had not been started
+  actions_.requeue(action);
+  auto robot_node = G_->get_node(robot_name_);
+  if (robot_node.has_value()) {
+    DSR::replace_edge<wants_to_edge_type>(
+      G_, robot_node.value().id(), action.id, "is_performing", robot_name_);
+  }
+  logger_->info("Action {} interrupted by an action with higher priority", action.id);
+}
+
+void SpeechAgent::prefetchSpeech()
+{
+  std::size_t requested = 0;
+  for (const auto & action : actions_) {
+    if (requested >= lookahead_) {
+      break;
+    }
+    uint64_t id = action.id;
+    auto action_node = G_->get_node(id);
+    if (action_node.has_value() && action_node.value().name() == "say") {
+      auto text = G_->get_attrib_by_name<text_att>(action_node.value());
+      if (text.has_value()) {
+        pipeline_.request(id, text.value());
+        ++requested;
+      }
+    }
+  }
+}
+
 void SpeechAgent::edge_updated(std::uint64_t from, std::uint64_t to, const std::string & type)
 {
   // Check if the robot wants to abort or cancel the speech: robot ---(abort)--> say/play
@@ -152,18 +371,30 @@ void SpeechAgent::edge_updated(std::uint64_t from, std::uint64_t to, const std::
       action_node.has_value() &&
       (action_node.value().name() == "play" || action_node.value().name() == "say") )
     {
-      // Remove the node from the list
-      actions_list_.erase(
-        std::remove(actions_list_.begin(), actions_list_.end(), to), actions_list_.end());
-      // Reset current_action
-      current_action_.reset();
+      // Only the action aborted is stopped, the rest are played as usual
+      bool sound_over_speech = sound_action_.has_value() && sound_action_->id == to;
+      bool current = current_action_.has_value() && current_action_->id == to;
+      if (sound_over_speech) {
+        sound_action_.reset();
+      } else {
+        // Remove the node from the queue
+        actions_.remove(to);
+        // Drop its audio if it was synthesized in advance
+        pipeline_.discard(to);
+        if (current) {
+          current_action_.reset();
+        }
+      }
       // Delete node say/play
       if (G_->delete_node(action_node.value().id())) {
         logger_->info("Delete node {}", action_node.value().name());
       }
       // Stop the components
-      sound_.stop();
-      speech_.stopMessage();
+      if (sound_over_speech) {
+        stopSoundOverSpeech();
+      } else if (current) {
+        stopPlayback();
+      }
     }
   }
   // Check if the robot wants to start the speech: robot ---(wants_to)--> say/play
@@ -174,10 +405,20 @@ void SpeechAgent::edge_updated(std::uint64_t from, std::uint64_t to, const std::
       action_node.has_value() &&
       (action_node.value().name() == "play" || action_node.value().name() == "say") )
     {
-      // Add node to the list if it is not in the list
-      if (std::find(actions_list_.begin(), actions_list_.end(), to) == actions_list_.end()) {
-        actions_list_.push_back(to);
-        logger_->info("New 'wants_to' edge to {} node detected", action_node.value().name());
+      // Add node to the queue if it is not in the queue
+      int priority = DSR::get_priority(G_, action_node.value());
+      if (actions_.push(to, priority)) {
+        logger_->info(
+          "New 'wants_to' edge to {} node detected with priority {}", action_node.value().name(),
+          priority);
+        // Urgent actions don't wait for the current one
+        if (current_action_.has_value() && preemption_threshold_ > 0 &&
+          priority >= current_action_->priority + preemption_threshold_)
+        {
+          preemptCurrentAction();
+        }
+        prefetchSpeech();
+        startSoundOverSpeech();
       }
     } else if (robot_node.has_value() && robot_node.value().name() == robot_name_ &&
       action_node.has_value() && (action_node.value().name() == "set_volume"))
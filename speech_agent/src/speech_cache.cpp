@@ -0,0 +1,281 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "speechAgent/speech_cache.hpp"
+
+namespace
+{
+std::size_t bufferSize(const audioBuffer & buffer)
+{
+  return buffer.samples.size() * sizeof(int16_t);
+}
+
+template<typename T>
+void writeValue(std::ofstream & file, const T & value)
+{
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::ifstream & file, T & value)
+{
+  return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+}  // namespace
+
+SpeechCache::SpeechCache()
+: max_memory_size_(kDefaultMemorySize), max_disk_size_(0)
+{
+}
+
+void SpeechCache::configure(
+  std::size_t max_memory_size, std::string disk_path, std::size_t max_disk_size)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_memory_size_ = max_memory_size;
+  disk_path_ = disk_path;
+  max_disk_size_ = max_disk_size;
+
+  memory_.clear();
+  memory_index_.clear();
+  stats_.memory_bytes = 0;
+  if (!disk_path_.empty()) {
+    std::error_code error;
+    std::filesystem::create_directories(disk_path_, error);
+    if (error) {
+      std::cerr << LOGTAG << "Cannot create " << disk_path_ << ": " << error.message() << std::endl;
+      disk_path_.clear();
+    }
+  }
+  indexDisk();
+}
+
+std::string SpeechCache::makeKey(
+  const std::string & text, const std::string & language, const std::string & voice, int rate,
+  int pitch)
+{
+  return language + '\n' + voice + '\n' + std::to_string(rate) + '\n' + std::to_string(pitch) +
+         '\n' + text;
+}
+
+bool SpeechCache::get(const std::string & key, audioBuffer & buffer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t key_hash = hash(key);
+
+  auto it = memory_index_.find(key_hash);
+  if (it != memory_index_.end() && it->second->key == key) {
+    // Most recently used
+    memory_.splice(memory_.end(), memory_, it->second);
+    buffer = it->second->buffer;
+    ++stats_.memory_hits;
+    return true;
+  }
+  if (readDisk(key_hash, key, buffer)) {
+    putMemory(key_hash, key, buffer);
+    ++stats_.disk_hits;
+    return true;
+  }
+  ++stats_.misses;
+  return false;
+}
+
+void SpeechCache::put(const std::string & key, const audioBuffer & buffer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t key_hash = hash(key);
+  putMemory(key_hash, key, buffer);
+  writeDisk(key_hash, key, buffer);
+}
+
+speechCacheStats SpeechCache::stats() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+uint64_t SpeechCache::hash(const std::string & key)
+{
+  uint64_t result = 0xcbf29ce484222325ULL;
+  for (unsigned char c : key) {
+    result ^= c;
+    result *= 0x100000001b3ULL;
+  }
+  return result;
+}
+
+std::filesystem::path SpeechCache::diskFile(uint64_t key_hash) const
+{
+  char name[24];
+  std::snprintf(name, sizeof(name), "%016llx.pcm", static_cast<unsigned long long>(key_hash));
+  return disk_path_ / name;
+}
+
+void SpeechCache::putMemory(uint64_t key_hash, const std::string & key, const audioBuffer & buffer)
+{
+  std::size_t size = bufferSize(buffer);
+  if (size > max_memory_size_) {
+    return;
+  }
+
+  // Replace the previous audio of the hash
+  if (auto it = memory_index_.find(key_hash); it != memory_index_.end()) {
+    stats_.memory_bytes -= bufferSize(it->second->buffer);
+    memory_.erase(it->second);
+    memory_index_.erase(it);
+  }
+  while (!memory_.empty() && stats_.memory_bytes + size > max_memory_size_) {
+    stats_.memory_bytes -= bufferSize(memory_.front().buffer);
+    memory_index_.erase(hash(memory_.front().key));
+    memory_.pop_front();
+  }
+  memory_index_[key_hash] = memory_.insert(memory_.end(), memoryEntry{key, buffer});
+  stats_.memory_bytes += size;
+}
+
+bool SpeechCache::readDisk(uint64_t key_hash, const std::string & key, audioBuffer & buffer)
+{
+  auto it = disk_index_.find(key_hash);
+  if (it == disk_index_.end()) {
+    return false;
+  }
+
+  std::ifstream file(diskFile(key_hash), std::ios::binary);
+  uint32_t magic = 0, key_size = 0;
+  uint64_t num_samples = 0;
+  audioBuffer stored;
+  std::string stored_key;
+  if (!readValue(file, magic) || magic != kFileMagic || !readValue(file, stored.sample_rate) ||
+    !readValue(file, stored.channels) || !readValue(file, key_size))
+  {
+    return false;
+  }
+  stored_key.resize(key_size);
+  if (!file.read(stored_key.data(), key_size) || stored_key != key ||
+    !readValue(file, num_samples))
+  {
+    return false;
+  }
+  stored.samples.resize(num_samples);
+  if (!file.read(reinterpret_cast<char *>(stored.samples.data()), bufferSize(stored))) {
+    return false;
+  }
+  buffer = std::move(stored);
+
+  // Most recently used, also for the next runs
+  disk_.splice(disk_.end(), disk_, it->second);
+  std::error_code error;
+  std::filesystem::last_write_time(
+    diskFile(key_hash), std::filesystem::file_time_type::clock::now(), error);
+  return true;
+}
+
+void SpeechCache::writeDisk(uint64_t key_hash, const std::string & key, const audioBuffer & buffer)
+{
+  if (disk_path_.empty() || bufferSize(buffer) > max_disk_size_) {
+    return;
+  }
+
+  // Write to a temporary file and rename it, so a file is never read half written
+  auto path = diskFile(key_hash);
+  auto tmp_path = path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    writeValue(file, kFileMagic);
+    writeValue(file, buffer.sample_rate);
+    writeValue(file, buffer.channels);
+    writeValue(file, static_cast<uint32_t>(key.size()));
+    file.write(key.data(), key.size());
+    writeValue(file, static_cast<uint64_t>(buffer.samples.size()));
+    file.write(reinterpret_cast<const char *>(buffer.samples.data()), bufferSize(buffer));
+    if (!file) {
+      std::cerr << LOGTAG << "Cannot write " << tmp_path << std::endl;
+      return;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(tmp_path, path, error);
+  if (error) {
+    std::cerr << LOGTAG << "Cannot write " << path << ": " << error.message() << std::endl;
+    return;
+  }
+
+  std::size_t size = std::filesystem::file_size(path, error);
+  if (auto it = disk_index_.find(key_hash); it != disk_index_.end()) {
+    stats_.disk_bytes -= it->second->size;
+    disk_.erase(it->second);
+    disk_index_.erase(it);
+  }
+  while (!disk_.empty() && stats_.disk_bytes + size > max_disk_size_) {
+    std::filesystem::remove(diskFile(disk_.front().hash), error);
+    stats_.disk_bytes -= disk_.front().size;
+    disk_index_.erase(disk_.front().hash);
+    disk_.pop_front();
+  }
+  disk_index_[key_hash] = disk_.insert(disk_.end(), diskEntry{key_hash, size});
+  stats_.disk_bytes += size;
+}
+
+void SpeechCache::indexDisk()
+{
+  disk_.clear();
+  disk_index_.clear();
+  stats_.disk_bytes = 0;
+  if (disk_path_.empty()) {
+    return;
+  }
+
+  struct diskFileInfo
+  {
+    std::filesystem::file_time_type time;
+    diskEntry entry;
+  };
+  std::vector<diskFileInfo> files;
+  std::error_code error;
+  for (const auto & file : std::filesystem::directory_iterator(disk_path_, error)) {
+    if (!file.is_regular_file() || file.path().extension() != ".pcm") {
+      continue;
+    }
+    auto name = file.path().stem().string();
+    uint64_t key_hash = 0;
+    auto [end, result] = std::from_chars(name.data(), name.data() + name.size(), key_hash, 16);
+    if (result != std::errc() || end != name.data() + name.size()) {
+      continue;
+    }
+    files.push_back({file.last_write_time(), diskEntry{key_hash, file.file_size()}});
+  }
+  std::sort(
+    files.begin(), files.end(), [](const auto & a, const auto & b) {return a.time < b.time;});
+
+  for (const auto & file : files) {
+    disk_index_[file.entry.hash] = disk_.insert(disk_.end(), file.entry);
+    stats_.disk_bytes += file.entry.size;
+  }
+  // The limit may be lower than in the previous run
+  while (!disk_.empty() && stats_.disk_bytes > max_disk_size_) {
+    std::filesystem::remove(diskFile(disk_.front().hash), error);
+    stats_.disk_bytes -= disk_.front().size;
+    disk_index_.erase(disk_.front().hash);
+    disk_.pop_front();
+  }
+}
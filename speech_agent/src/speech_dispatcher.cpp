@@ -13,19 +13,26 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <cstdlib>
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
-#include <sstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
+#include "speechAgent/audio_effects.hpp"
 #include "speechAgent/speech_dispatcher.hpp"
+#include "speechAgent/text_splitter.hpp"
 
-// TODO: Check wav+filter:
-//		text="Ya me marcho, muchas gracias por escucharme, que tengan un buen día y disfruten de los eventos. Nos vemos pronto"
-//		pico2wave -l "es-ES" -w pico.wav "$text" && play -qV0 pico.wav treble 24 gain -l -6
+// Treble boost of the Pico voice, the 'treble 18' of the old 'play' command
+static constexpr double PICO_TREBLE_DB = 18.0;
 
 
 // Functions
 SpeechDispatcher::SpeechDispatcher()
+: ssip("speechAgent"), output(createAudioBackend("pulse", "speechAgent", ""))
 {
   // Initialize variables
   outModule = "pico";
@@ -42,43 +49,128 @@ SpeechDispatcher::~SpeechDispatcher()
 bool SpeechDispatcher::say(const std::string & text)
 {
   if (DEBUG) {std::cout << LOGTAG << "Saying \"" << text << "\"" << std::endl;}
-  const std::string command = "spd-say " + processConfigOptions() + " \"" + text + "\"";
-  std::cout << "JP: config to say: " << command << std::endl;
-  return runCommand(command);
+  int messageId = 0;
+  return applyConfig() && ssip.speak(text, messageId);
 }
 bool SpeechDispatcher::sayAndWait(const std::string & text)
 {
   if (DEBUG) {
     std::cout << LOGTAG << "Waiting until \"" << text << "\" is spoken or discarded" << std::endl;
   }
-  const std::string command = "spd-say " + processConfigOptions() + " -w \"" + text + "\"";
-  return runCommand(command);
+  int messageId = 0;
+  return applyConfig() && ssip.speak(text, messageId) && ssip.waitUntilSpoken(messageId);
 }
 bool SpeechDispatcher::sayWithPicoAndWait(const std::string & text)              // TODO FIXME: Temporary fix to make better sound. Put it into other class, it's not related to SpeechDispatcher
 {
   if (DEBUG) {std::cout << LOGTAG << "Saying \"" << text << "\"" << std::endl;}
+  return sayStreamingWithPicoAndWait(text);
+}
 
-  const std::string filename = "/tmp/picotmp.wav";
-//	const std::string command = "pico2wave -l es-ES -w \""+filename+"\" \""+text+"\" && play -qV2 \""+filename+"\" treble 18";
+bool SpeechDispatcher::synthesizeWithPico(
+  const std::string & text, audioBuffer & buffer, const std::atomic<bool> * cancel)
+{
+  if (DEBUG) {std::cout << LOGTAG << "Synthesizing \"" << text << "\"" << std::endl;}
 
-  int pico_volume = (int)(volume / 2);     // pico volume goes from -50 to 50
-  std::string volume_s = std::to_string(pico_volume);
-  const std::string command = "pico2wave -l es-ES -w \"" + filename + "\" \"" + text +
-    "\" && play -qV2 \"" + filename + "\" treble 18 gain -l " + volume_s;
-  if (DEBUG) {std::cout << "Command to say: " << command << std::endl;}
-  return runCommand(command);
+  // The voice is loaded once, the first time if it was not configured
+  if (!tts.isInitialized() && !tts.initialize(picoLangPath, picoLanguage)) {
+    return false;
+  }
+  // Each sentence is cached on its own, so it is shared with the texts said by sentences
+  buffer.samples.clear();
+  for (const auto & sentence : splitText(text)) {
+    // The sentence is only synthesized the first time it is said with these settings
+    const std::string key = SpeechCache::makeKey(sentence, picoLanguage, tts.voice(), rate, pitch);
+    audioBuffer sentence_buffer;
+    if (!cache.get(key, sentence_buffer)) {
+      if (!tts.synthesize(sentence, sentence_buffer, rate, pitch, cancel)) {
+        return false;
+      }
+      cache.put(key, sentence_buffer);
+    }
+    buffer.sample_rate = sentence_buffer.sample_rate;
+    buffer.channels = sentence_buffer.channels;
+    buffer.samples.insert(
+      buffer.samples.end(), sentence_buffer.samples.begin(), sentence_buffer.samples.end());
+  }
+  return true;
+}
+
+bool SpeechDispatcher::playWithPicoAndWait(audioBuffer buffer, const std::atomic<bool> * cancel)
+{
+  if (DEBUG) {std::cout << LOGTAG << "Playing " << buffer.samples.size() << " samples" << std::endl;}
+  filterPico(buffer);
+  return output->play(buffer, cancel);
+}
+
+bool SpeechDispatcher::sayStreamingWithPicoAndWait(
+  const std::string & text, const std::atomic<bool> * cancel)
+{
+  if (DEBUG) {std::cout << LOGTAG << "Saying by sentences \"" << text << "\"" << std::endl;}
+  auto sentences = splitText(text);
+  if (sentences.size() <= 1) {
+    audioBuffer buffer;
+    return synthesizeWithPico(text, buffer, cancel) &&
+           playWithPicoAndWait(std::move(buffer), cancel);
+  }
+
+  // The sentences are synthesized in another thread and played here as soon as they are ready
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<audioBuffer> ready;
+  bool finished = false;
+  std::atomic<bool> stop_synthesis = false;
+  std::thread synthesis([&]() {
+      for (const auto & sentence : sentences) {
+        audioBuffer buffer;
+        if (stop_synthesis || (cancel != nullptr && *cancel) ||
+          !synthesizeWithPico(sentence, buffer, cancel))
+        {
+          break;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(std::move(buffer));
+        cv.notify_one();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      finished = true;
+      cv.notify_one();
+    });
+
+  std::size_t played = 0;
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() {return !ready.empty() || finished;});
+    if (ready.empty()) {
+      break;
+    }
+    audioBuffer buffer = std::move(ready.front());
+    ready.pop_front();
+    lock.unlock();
+
+    // The sentences are sent one after the other, without waiting for the previous one
+    filterPico(buffer);
+    if (!output->write(buffer, cancel)) {
+      break;
+    }
+    ++played;
+  }
+  stop_synthesis = true;
+  synthesis.join();
+  return output->drain(cancel) && played == sentences.size();
 }
 
 bool SpeechDispatcher::stopMessage()
 {
   if (DEBUG) {std::cout << LOGTAG << "Stop saying current message" << std::endl;}
-  return runCommand("spd-say -S");
+  output->stop();
+  return ssip.stop();
 }
 
 bool SpeechDispatcher::cancel()
 {
   if (DEBUG) {std::cout << LOGTAG << "Stop saying all messages" << std::endl;}
-  return runCommand("spd-say -C");
+  output->stop();
+  return ssip.cancel();
 }
 
 // Config functions
@@ -106,6 +198,32 @@ void SpeechDispatcher::configVoice(const std::string & str)
   voice = str;
 }
 
+bool SpeechDispatcher::configPicoLanguage(const std::string & langPath, const std::string & str)
+{
+  if (DEBUG) {
+    std::cout << LOGTAG << "Loading Pico voice " << str << " from " << langPath << std::endl;
+  }
+  picoLangPath = langPath;
+  picoLanguage = str;
+  return tts.initialize(picoLangPath, picoLanguage);
+}
+
+void SpeechDispatcher::configCache(
+  const std::size_t & memorySize, const std::string & path, const std::size_t & diskSize)
+{
+  if (DEBUG) {
+    std::cout << LOGTAG << "Setting speech cache to " << memorySize << " bytes in memory and " <<
+      diskSize << " bytes in '" << path << "'" << std::endl;
+  }
+  cache.configure(memorySize, path, diskSize);
+}
+
+void SpeechDispatcher::configOutput(std::unique_ptr<AudioBackend> backend)
+{
+  if (DEBUG) {std::cout << LOGTAG << "Setting audio output" << std::endl;}
+  output = std::move(backend);
+}
+
 bool SpeechDispatcher::configSpeechVolume(const int & value)
 {
   if ((value < -100) || (value > 100)) {
@@ -150,23 +268,31 @@ bool SpeechDispatcher::configPitchRange(const int & value)
   return true;
 }
 
-std::string SpeechDispatcher::processConfigOptions()
+// Cache functions
+speechCacheStats SpeechDispatcher::cacheStats() const
 {
-  std::ostringstream out;
-  if (!outModule.empty()) {out << " -o " << outModule;}
-  if (!language.empty()) {out << " -l " << language;}
-  if (!voiceType.empty()) {out << " -t " << voiceType;}
-  if (!voice.empty()) {out << " -y " << voice;}
-  if (volume != 100) {out << " -i " << volume;}
-  if (rate != 0) {out << " -r " << rate;}
-  if (pitch != 0) {out << " -p " << pitch;}
-  if (pitchRange != 0) {out << " -R " << pitchRange;}
-  return out.str();
+  return cache.stats();
+}
+
+void SpeechDispatcher::filterPico(audioBuffer & buffer)
+{
+  // Same filter as 'play ... treble 18 gain -l <volume>'
+  int pico_volume = (int)(volume / 2);     // pico volume goes from -50 to 50
+  applyTreble(buffer, PICO_TREBLE_DB);
+  applyGain(buffer, pico_volume, true);
 }
 
-// Helpers
-bool SpeechDispatcher::runCommand(const std::string & command)
+bool SpeechDispatcher::applyConfig()
 {
-  if (DEBUG) {std::cout << LOGTAG << "Running command: '" << command << "'" << std::endl;}
-  return std::system(command.c_str()) == 0;
+  // The client only sends the settings changed since the last message
+  std::string type = voiceType;
+  std::transform(type.begin(), type.end(), type.begin(), ::toupper);
+  return (outModule.empty() || ssip.set("OUTPUT_MODULE", outModule)) &&
+         (language.empty() || ssip.set("LANGUAGE", language)) &&
+         (type.empty() || ssip.set("VOICE_TYPE", type)) &&
+         (voice.empty() || ssip.set("SYNTHESIS_VOICE", voice)) &&
+         ssip.set("VOLUME", std::to_string(volume)) &&
+         ssip.set("RATE", std::to_string(rate)) &&
+         ssip.set("PITCH", std::to_string(pitch)) &&
+         ssip.set("PITCH_RANGE", std::to_string(pitchRange));
 }
@@ -0,0 +1,331 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// SOCKETS
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "speechAgent/ssip_client.hpp"
+
+namespace
+{
+// Codes of the replies and the events of SSIP
+constexpr int kCodeReceivingData = 230;
+constexpr int kCodeMessageQueued = 225;
+constexpr int kCodeEventEnd = 702;
+constexpr int kCodeEventCanceled = 703;
+
+// Started when the server is not running, like the clients of speech-dispatcher do
+constexpr const char * kSpawnCommand = "speech-dispatcher --spawn";
+
+bool isSuccess(int code)
+{
+  return code >= 200 && code < 300;
+}
+
+int parseNumber(const std::string & text)
+{
+  int value = -1;
+  std::from_chars(text.data(), text.data() + text.size(), value);
+  return value;
+}
+
+bool writeAll(int socket, const std::string & data)
+{
+  std::size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t size = ::send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (size < 0) {
+      return false;
+    }
+    sent += static_cast<std::size_t>(size);
+  }
+  return true;
+}
+
+int openSocket(const std::string & path)
+{
+  sockaddr_un address{};
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    return -1;
+  }
+  int socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socket < 0) {
+    return -1;
+  }
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  if (::connect(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+    ::close(socket);
+    return -1;
+  }
+  return socket;
+}
+}  // namespace
+
+SsipClient::SsipClient(std::string name)
+: name_(name), socket_(-1), connected_(false), connection_(0)
+{
+}
+
+SsipClient::~SsipClient()
+{
+  std::lock_guard<std::mutex> lock(command_mutex_);
+  if (socket_ >= 0) {
+    writeAll(socket_, "QUIT\r\n");
+  }
+  disconnect();
+}
+
+bool SsipClient::set(const std::string & setting, const std::string & value)
+{
+  std::lock_guard<std::mutex> lock(command_mutex_);
+  if (!connect()) {
+    return false;
+  }
+  if (auto it = settings_.find(setting); it != settings_.end() && it->second == value) {
+    return true;
+  }
+  ssipReply reply;
+  if (!send("SET self " + setting + " " + value, reply)) {
+    std::cerr << LOGTAG << "Cannot set " << setting << " to " << value << " (" << reply.code <<
+      ")" << std::endl;
+    return false;
+  }
+  settings_[setting] = value;
+  return true;
+}
+
+bool SsipClient::speak(const std::string & text, int & message_id)
+{
+  std::lock_guard<std::mutex> lock(command_mutex_);
+  if (!connect()) {
+    return false;
+  }
+  ssipReply reply;
+  if (!send("SPEAK", reply) || reply.code != kCodeReceivingData) {
+    std::cerr << LOGTAG << "Cannot start a message (" << reply.code << ")" << std::endl;
+    return false;
+  }
+
+  // The lines starting with a dot are escaped, and a line with a dot ends the text
+  std::istringstream lines(text);
+  std::string line, data;
+  while (std::getline(lines, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    data += (!line.empty() && line.front() == '.' ? "." : "") + line + "\r\n";
+  }
+  data += ".";
+  if (!send(data, reply) || reply.code != kCodeMessageQueued || reply.lines.empty()) {
+    std::cerr << LOGTAG << "Cannot queue the message (" << reply.code << ")" << std::endl;
+    return false;
+  }
+  message_id = parseNumber(reply.lines.front());
+  return true;
+}
+
+bool SsipClient::waitUntilSpoken(int message_id)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t connection = connection_;
+  cv_.wait(
+    lock, [&]() {
+      return finished_.count(message_id) > 0 || !connected_ || connection != connection_;
+    });
+  auto it = finished_.find(message_id);
+  if (it == finished_.end()) {
+    return false;
+  }
+  bool spoken = it->second;
+  finished_.erase(it);
+  return spoken;
+}
+
+bool SsipClient::stop()
+{
+  std::lock_guard<std::mutex> lock(command_mutex_);
+  // The server discards the messages of a client when it disconnects
+  if (!connected()) {
+    return true;
+  }
+  ssipReply reply;
+  return send("STOP self", reply);
+}
+
+bool SsipClient::cancel()
+{
+  std::lock_guard<std::mutex> lock(command_mutex_);
+  if (!connected()) {
+    return true;
+  }
+  ssipReply reply;
+  return send("CANCEL self", reply);
+}
+
+bool SsipClient::connect()
+{
+  if (connected()) {
+    return true;
+  }
+  // The previous connection was closed by the server
+  disconnect();
+
+  std::string path = socketPath();
+  int socket = openSocket(path);
+  if (socket < 0 && std::system(kSpawnCommand) == 0) {
+    socket = openSocket(path);
+  }
+  if (socket < 0) {
+    std::cerr << LOGTAG << "Cannot connect to speech-dispatcher at '" << path << "'" << std::endl;
+    return false;
+  }
+  socket_ = socket;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    connected_ = true;
+  }
+  reader_ = std::thread(&SsipClient::readMessages, this, socket_);
+
+  // The server notifies the end of the messages to this connection
+  const char * user = std::getenv("USER");
+  ssipReply reply;
+  if (!send(
+      "SET self CLIENT_NAME " + std::string(user != nullptr ? user : "unknown") + ":" + name_ +
+      ":main", reply) ||
+    !send("SET self NOTIFICATION ALL on", reply))
+  {
+    std::cerr << LOGTAG << "Cannot set up the connection (" << reply.code << ")" << std::endl;
+    disconnect();
+    return false;
+  }
+  return true;
+}
+
+void SsipClient::disconnect()
+{
+  if (socket_ >= 0) {
+    // Wake up the reader thread
+    ::shutdown(socket_, SHUT_RDWR);
+  }
+  if (reader_.joinable()) {
+    reader_.join();
+  }
+  if (socket_ >= 0) {
+    ::close(socket_);
+    socket_ = -1;
+  }
+  settings_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  connected_ = false;
+  ++connection_;
+  replies_.clear();
+  cv_.notify_all();
+}
+
+bool SsipClient::connected()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return connected_;
+}
+
+bool SsipClient::send(const std::string & command, ssipReply & reply)
+{
+  reply = ssipReply();
+  if (!writeAll(socket_, command + "\r\n")) {
+    std::cerr << LOGTAG << "Cannot send the command: " << std::strerror(errno) << std::endl;
+    disconnect();
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!cv_.wait_for(lock, kReplyTimeout, [this]() {return !replies_.empty() || !connected_;}) ||
+    replies_.empty())
+  {
+    lock.unlock();
+    std::cerr << LOGTAG << "No reply from speech-dispatcher" << std::endl;
+    disconnect();
+    return false;
+  }
+  reply = std::move(replies_.front());
+  replies_.pop_front();
+  return isSuccess(reply.code);
+}
+
+void SsipClient::readMessages(int socket)
+{
+  // Each line is '<code>-<text>' but the last one of a message, that is '<code> <text>'
+  std::string pending;
+  std::vector<std::string> lines;
+  char data[4096];
+  ssize_t size;
+  while ((size = ::recv(socket, data, sizeof(data), 0)) > 0) {
+    pending.append(data, static_cast<std::size_t>(size));
+    std::size_t end;
+    while ((end = pending.find("\r\n")) != std::string::npos) {
+      std::string line = pending.substr(0, end);
+      pending.erase(0, end + 2);
+      if (line.size() < 4) {
+        continue;
+      }
+      lines.push_back(line.substr(4));
+      if (line[3] != '-') {
+        handleMessage(parseNumber(line.substr(0, 3)), std::move(lines));
+        lines.clear();
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  connected_ = false;
+  cv_.notify_all();
+}
+
+void SsipClient::handleMessage(int code, std::vector<std::string> lines)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (code / 100 != 7) {
+    replies_.push_back({code, std::move(lines)});
+  } else if ((code == kCodeEventEnd || code == kCodeEventCanceled) && !lines.empty()) {
+    // The first line of an event is the id of the message
+    finished_[parseNumber(lines.front())] = code == kCodeEventEnd;
+    if (finished_.size() > kMaxFinished) {
+      finished_.erase(finished_.begin());
+    }
+  }
+  cv_.notify_all();
+}
+
+std::string SsipClient::socketPath()
+{
+  if (const char * address = std::getenv("SPEECHD_ADDRESS"); address != nullptr) {
+    const std::string prefix = "unix_socket:";
+    if (std::string value = address; value.rfind(prefix, 0) == 0) {
+      return value.substr(prefix.size());
+    }
+  }
+  if (const char * runtime = std::getenv("XDG_RUNTIME_DIR"); runtime != nullptr) {
+    return std::string(runtime) + "/speech-dispatcher/speechd.sock";
+  }
+  const char * home = std::getenv("HOME");
+  return std::string(home != nullptr ? home : "") + "/.cache/speech-dispatcher/speechd.sock";
+}
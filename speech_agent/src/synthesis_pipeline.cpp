@@ -0,0 +1,144 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "speechAgent/synthesis_pipeline.hpp"
+
+SynthesisPipeline::SynthesisPipeline(synthesizeFunction synthesize, std::size_t lookahead)
+: synthesize_(synthesize), lookahead_(lookahead), running_(true)
+{
+  thread_ = std::thread(&SynthesisPipeline::run, this);
+}
+
+SynthesisPipeline::~SynthesisPipeline()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void SynthesisPipeline::setLookahead(std::size_t lookahead)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  lookahead_ = lookahead;
+}
+
+void SynthesisPipeline::request(uint64_t id, const std::string & text)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (jobs_.size() >= lookahead_ || find(id) != jobs_.end()) {
+      return;
+    }
+    jobs_.push_back(
+      job{id, text, jobState::QUEUED, false, std::make_shared<std::atomic<bool>>(false),
+        audioBuffer()});
+  }
+  cv_.notify_all();
+}
+
+bool SynthesisPipeline::take(uint64_t id, audioBuffer & buffer)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = find(id);
+  if (it == jobs_.end()) {
+    return false;
+  }
+  // Waiting for the whole text would delay the first sentence, so the caller says it by
+  // sentences. The sentences already synthesized are in the cache
+  if (it->state == jobState::RUNNING) {
+    it->discarded = true;
+    *it->cancel = true;
+    return false;
+  }
+  bool ready = it->state == jobState::READY;
+  if (ready) {
+    buffer = std::move(it->buffer);
+  }
+  jobs_.erase(it);
+  return ready;
+}
+
+void SynthesisPipeline::discard(uint64_t id)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  drop([id](const job & j) {return j.id == id;});
+}
+
+void SynthesisPipeline::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  drop([](const job &) {return true;});
+}
+
+void SynthesisPipeline::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    auto it = jobs_.end();
+    cv_.wait(
+      lock, [this, &it] {
+        it = std::find_if(
+          jobs_.begin(), jobs_.end(), [](const job & j) {return j.state == jobState::QUEUED;});
+        return !running_ || it != jobs_.end();
+      });
+    if (!running_) {
+      break;
+    }
+
+    // Only this thread erases the job while it is RUNNING, so the iterator stays valid
+    it->state = jobState::RUNNING;
+    std::string text = it->text;
+    auto cancel = it->cancel;
+    lock.unlock();
+    audioBuffer buffer;
+    bool success = synthesize_(text, buffer, cancel.get());
+    lock.lock();
+
+    if (it->discarded) {
+      jobs_.erase(it);
+    } else {
+      it->state = success ? jobState::READY : jobState::FAILED;
+      it->buffer = std::move(buffer);
+    }
+  }
+}
+
+std::list<SynthesisPipeline::job>::iterator SynthesisPipeline::find(uint64_t id)
+{
+  return std::find_if(
+    jobs_.begin(), jobs_.end(), [id](const job & j) {return j.id == id && !j.discarded;});
+}
+
+void SynthesisPipeline::drop(const std::function<bool(const job &)> & condition)
+{
+  for (auto it = jobs_.begin(); it != jobs_.end(); ) {
+    if (!condition(*it)) {
+      ++it;
+    } else if (it->state == jobState::RUNNING) {
+      it->discarded = true;
+      *it->cancel = true;
+      ++it;
+    } else {
+      it = jobs_.erase(it);
+    }
+  }
+}
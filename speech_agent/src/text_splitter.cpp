@@ -0,0 +1,55 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cctype>
+
+#include "speechAgent/text_splitter.hpp"
+
+namespace
+{
+bool isSpace(char c)
+{
+  return std::isspace(static_cast<unsigned char>(c));
+}
+
+void addSegment(std::vector<std::string> & segments, const std::string & text)
+{
+  auto first = text.find_first_not_of(" \t\r\n");
+  if (first != std::string::npos) {
+    auto last = text.find_last_not_of(" \t\r\n");
+    segments.push_back(text.substr(first, last - first + 1));
+  }
+}
+}  // namespace
+
+std::vector<std::string> splitText(const std::string & text, std::size_t min_clause_length)
+{
+  std::vector<std::string> segments;
+  std::string current;
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    current += c;
+    // Not in numbers like 3.5 or 10:30
+    bool boundary = i + 1 == text.size() || isSpace(text[i + 1]);
+    bool sentence_end = c == '.' || c == '!' || c == '?' || c == ';' || c == ':' || c == '\n';
+    bool clause_end = c == ',' && current.size() >= min_clause_length;
+    if (boundary && (sentence_end || clause_end)) {
+      addSegment(segments, current);
+      current.clear();
+    }
+  }
+  addSegment(segments, current);
+  return segments;
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+#include "speechAgent/tts_engine.hpp"
+
+namespace
+{
+// Text analysis and signal generation files of each language
+const std::map<std::string, std::pair<std::string, std::string>> kLanguageFiles = {
+  {"es-ES", {"es-ES_ta.bin", "es-ES_zl0_sg.bin"}},
+  {"en-US", {"en-US_ta.bin", "en-US_lh0_sg.bin"}},
+  {"en-GB", {"en-GB_ta.bin", "en-GB_kh0_sg.bin"}},
+  {"de-DE", {"de-DE_ta.bin", "de-DE_gl0_sg.bin"}},
+  {"fr-FR", {"fr-FR_ta.bin", "fr-FR_nk0_sg.bin"}},
+  {"it-IT", {"it-IT_ta.bin", "it-IT_cm0_sg.bin"}}
+};
+
+const pico_Char * picoString(const std::string & str)
+{
+  return reinterpret_cast<const pico_Char *>(str.c_str());
+}
+}  // namespace
+
+TtsEngine::TtsEngine()
+: system_(nullptr), ta_resource_(nullptr), sg_resource_(nullptr), engine_(nullptr)
+{
+}
+
+TtsEngine::~TtsEngine()
+{
+  release();
+}
+
+bool TtsEngine::initialize(const std::string & lang_path, const std::string & language)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  release();
+
+  auto files = kLanguageFiles.find(language);
+  if (files == kLanguageFiles.end()) {
+    std::cerr << LOGTAG << "Language not supported by Pico: " << language << std::endl;
+    return false;
+  }
+  std::string dir = lang_path.empty() || lang_path.back() == '/' ? lang_path : lang_path + "/";
+
+  memory_.resize(kMemorySize);
+  pico_Status status = pico_initialize(memory_.data(), memory_.size(), &system_);
+  if (status != PICO_OK) {
+    printError("Cannot initialize Pico", status);
+    system_ = nullptr;
+    return false;
+  }
+
+  // Load the resources and create a voice with them
+  pico_Retstring ta_name, sg_name;
+  if ((status = pico_loadResource(system_, picoString(dir + files->second.first), &ta_resource_))
+    != PICO_OK ||
+    (status = pico_loadResource(system_, picoString(dir + files->second.second), &sg_resource_))
+    != PICO_OK ||
+    (status = pico_getResourceName(system_, ta_resource_, ta_name)) != PICO_OK ||
+    (status = pico_getResourceName(system_, sg_resource_, sg_name)) != PICO_OK ||
+    (status = pico_createVoiceDefinition(system_, picoString(kVoiceName))) != PICO_OK ||
+    (status = pico_addResourceToVoiceDefinition(
+      system_, picoString(kVoiceName), reinterpret_cast<const pico_Char *>(ta_name))) != PICO_OK ||
+    (status = pico_addResourceToVoiceDefinition(
+      system_, picoString(kVoiceName), reinterpret_cast<const pico_Char *>(sg_name))) != PICO_OK ||
+    (status = pico_newEngine(system_, picoString(kVoiceName), &engine_)) != PICO_OK)
+  {
+    printError("Cannot load the voice " + language + " from " + dir, status);
+    release();
+    return false;
+  }
+  voice_ = files->second.second;
+  return true;
+}
+
+bool TtsEngine::isInitialized() const
+{
+  return engine_ != nullptr;
+}
+
+const std::string & TtsEngine::voice() const
+{
+  return voice_;
+}
+
+bool TtsEngine::synthesize(
+  const std::string & text, audioBuffer & buffer, int rate, int pitch,
+  const std::atomic<bool> * cancel)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (engine_ == nullptr) {
+    std::cerr << LOGTAG << "Cannot synthesize without a voice" << std::endl;
+    return false;
+  }
+
+  buffer.sample_rate = kSampleRate;
+  buffer.channels = 1;
+  buffer.samples.clear();
+
+  // The rate and the pitch are set with the markup of Pico, in percent of the default
+  std::string input = text;
+  if (rate != 0) {
+    input = "<speed level=\"" + std::to_string(100 + rate / 2) + "\">" + input + "</speed>";
+  }
+  if (pitch != 0) {
+    input = "<pitch level=\"" + std::to_string(100 + pitch / 2) + "\">" + input + "</pitch>";
+  }
+
+  // The null character at the end makes Pico flush the last sentence
+  const pico_Char * remaining = picoString(input);
+  std::size_t remaining_size = input.size() + 1;
+  int16_t samples[256];
+  while (remaining_size > 0) {
+    pico_Int16 bytes_put = 0;
+    pico_Int16 size = static_cast<pico_Int16>(std::min<std::size_t>(remaining_size, 0x7fff));
+    pico_Status status = pico_putTextUtf8(engine_, remaining, size, &bytes_put);
+    if (status != PICO_OK) {
+      printError("Cannot put the text", status);
+      pico_resetEngine(engine_, PICO_RESET_SOFT);
+      return false;
+    }
+    remaining += bytes_put;
+    remaining_size -= bytes_put;
+
+    // Get the audio of the text put so far
+    do {
+      if (cancel != nullptr && *cancel) {
+        pico_resetEngine(engine_, PICO_RESET_SOFT);
+        return false;
+      }
+      pico_Int16 bytes_received = 0, data_type = 0;
+      status = pico_getData(
+        engine_, samples, sizeof(samples), &bytes_received, &data_type);
+      if (status != PICO_STEP_BUSY && status != PICO_STEP_IDLE) {
+        printError("Cannot synthesize the text", status);
+        pico_resetEngine(engine_, PICO_RESET_SOFT);
+        return false;
+      }
+      buffer.samples.insert(
+        buffer.samples.end(), samples, samples + bytes_received / sizeof(int16_t));
+    } while (status == PICO_STEP_BUSY);
+  }
+  return true;
+}
+
+void TtsEngine::release()
+{
+  if (system_ == nullptr) {
+    return;
+  }
+  if (engine_ != nullptr) {
+    pico_disposeEngine(system_, &engine_);
+    pico_releaseVoiceDefinition(system_, picoString(kVoiceName));
+  }
+  if (sg_resource_ != nullptr) {
+    pico_unloadResource(system_, &sg_resource_);
+  }
+  if (ta_resource_ != nullptr) {
+    pico_unloadResource(system_, &ta_resource_);
+  }
+  pico_terminate(&system_);
+  voice_.clear();
+  engine_ = nullptr;
+  sg_resource_ = nullptr;
+  ta_resource_ = nullptr;
+  system_ = nullptr;
+}
+
+void TtsEngine::printError(const std::string & what, pico_Status status)
+{
+  pico_Retstring message = "";
+  if (system_ != nullptr) {
+    pico_getSystemStatusMessage(system_, status, message);
+  }
+  std::cerr << LOGTAG << what << " (" << status << "): " << message << std::endl;
+}
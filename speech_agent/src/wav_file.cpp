@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "speechAgent/wav_file.hpp"
+
+namespace
+{
+// Formats of the 'fmt ' chunk
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+uint16_t readU16(const char * data)
+{
+  return static_cast<uint16_t>(
+    static_cast<uint8_t>(data[0]) | (static_cast<uint8_t>(data[1]) << 8));
+}
+
+uint32_t readU32(const char * data)
+{
+  return readU16(data) | (static_cast<uint32_t>(readU16(data + 2)) << 16);
+}
+
+// Convert a little endian sample to 16 bits
+int16_t convertSample(const char * data, uint16_t format, uint16_t bits)
+{
+  if (format == kFormatFloat) {
+    float value;
+    std::memcpy(&value, data, sizeof(value));
+    return static_cast<int16_t>(std::clamp(std::lround(value * 32768.0f), -32768L, 32767L));
+  }
+  switch (bits) {
+    case 8:
+      // Unsigned
+      return static_cast<int16_t>((static_cast<uint8_t>(data[0]) - 128) << 8);
+    case 16:
+      return static_cast<int16_t>(readU16(data));
+    case 24:
+      return static_cast<int16_t>(readU16(data + 1));
+    default:
+      return static_cast<int16_t>(readU16(data + 2));
+  }
+}
+}  // namespace
+
+bool readWav(const std::string & filename, audioBuffer & buffer)
+{
+  std::ifstream file(filename, std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 ||
+    std::memcmp(data.data() + 8, "WAVE", 4) != 0)
+  {
+    return false;
+  }
+
+  uint16_t format = 0, channels = 0, bits = 0;
+  uint32_t sample_rate = 0;
+  std::size_t pos = 12;
+  while (pos + 8 <= data.size()) {
+    const char * chunk = data.data() + pos;
+    std::size_t size = std::min<std::size_t>(readU32(chunk + 4), data.size() - pos - 8);
+    if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+      format = readU16(chunk + 8);
+      channels = readU16(chunk + 10);
+      sample_rate = readU32(chunk + 12);
+      bits = readU16(chunk + 22);
+      // The real format is at the start of the subformat GUID
+      if (format == kFormatExtensible && size >= 26) {
+        format = readU16(chunk + 32);
+      }
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      bool supported = (format == kFormatPcm && (bits == 8 || bits == 16 || bits == 24 ||
+        bits == 32)) || (format == kFormatFloat && bits == 32);
+      if (!supported || channels == 0 || sample_rate == 0) {
+        return false;
+      }
+      std::size_t bytes = bits / 8;
+      buffer.sample_rate = sample_rate;
+      buffer.channels = channels;
+      buffer.samples.resize(size / bytes / channels * channels);
+      for (std::size_t i = 0; i < buffer.samples.size(); ++i) {
+        buffer.samples[i] = convertSample(chunk + 8 + i * bytes, format, bits);
+      }
+      return true;
+    }
+    // The chunks are aligned to 2 bytes
+    pos += 8 + size + (size & 1);
+  }
+  return false;
+}
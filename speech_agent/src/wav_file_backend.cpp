@@ -0,0 +1,144 @@
+// Copyright (c) 2024 Grupo Avispa, DTE, Universidad de Málaga
+// Copyright (c) 2024 Alberto J. Tudela Roldán
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <vector>
+
+#include "speechAgent/wav_file_backend.hpp"
+
+namespace
+{
+// Size of the header of a PCM file, before the samples
+constexpr uint32_t kHeaderSize = 44;
+
+void writeU16(std::vector<char> & data, uint16_t value)
+{
+  data.push_back(static_cast<char>(value & 0xFF));
+  data.push_back(static_cast<char>(value >> 8));
+}
+
+void writeU32(std::vector<char> & data, uint32_t value)
+{
+  writeU16(data, static_cast<uint16_t>(value & 0xFFFF));
+  writeU16(data, static_cast<uint16_t>(value >> 16));
+}
+}  // namespace
+
+WavFileBackend::WavFileBackend(std::string filename)
+: filename_(filename), sample_rate_(0), channels_(0), data_size_(0)
+{
+}
+
+WavFileBackend::~WavFileBackend()
+{
+  close();
+}
+
+bool WavFileBackend::write(const audioBuffer & buffer, const std::atomic<bool> * cancel)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stop_ = false;
+  if (stopped(cancel) || !open(buffer)) {
+    return false;
+  }
+
+  // The samples are stored in little endian whatever the machine is
+  std::vector<char> data;
+  data.reserve(buffer.samples.size() * sizeof(int16_t));
+  for (int16_t sample : buffer.samples) {
+    writeU16(data, static_cast<uint16_t>(sample));
+  }
+  file_.write(data.data(), static_cast<std::streamsize>(data.size()));
+  if (!file_) {
+    std::cerr << LOGTAG << "Cannot write the audio to " << filename_ << std::endl;
+    close();
+    return false;
+  }
+  data_size_ += static_cast<uint32_t>(data.size());
+  return true;
+}
+
+bool WavFileBackend::drain(const std::atomic<bool> * cancel)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_.is_open()) {
+    return false;
+  }
+  // The file is valid after each audio, so it can be read while the agent runs
+  writeHeader();
+  file_.flush();
+  return !stopped(cancel);
+}
+
+bool WavFileBackend::applyVolume(int)
+{
+  return true;
+}
+
+int WavFileBackend::readVolume()
+{
+  return kDefaultVolume;
+}
+
+bool WavFileBackend::open(const audioBuffer & buffer)
+{
+  if (file_.is_open() && sample_rate_ == buffer.sample_rate && channels_ == buffer.channels) {
+    return true;
+  }
+  close();
+
+  file_.open(filename_, std::ios::binary | std::ios::trunc);
+  if (!file_) {
+    std::cerr << LOGTAG << "Cannot create the file " << filename_ << std::endl;
+    file_.close();
+    return false;
+  }
+  sample_rate_ = buffer.sample_rate;
+  channels_ = buffer.channels;
+  data_size_ = 0;
+  writeHeader();
+  return true;
+}
+
+void WavFileBackend::close()
+{
+  if (file_.is_open()) {
+    writeHeader();
+    file_.close();
+  }
+}
+
+void WavFileBackend::writeHeader()
+{
+  std::vector<char> header;
+  header.reserve(kHeaderSize);
+  header.insert(header.end(), {'R', 'I', 'F', 'F'});
+  writeU32(header, kHeaderSize - 8 + data_size_);
+  header.insert(header.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  writeU32(header, 16);
+  writeU16(header, 1);
+  writeU16(header, channels_);
+  writeU32(header, sample_rate_);
+  writeU32(header, sample_rate_ * channels_ * sizeof(int16_t));
+  writeU16(header, static_cast<uint16_t>(channels_ * sizeof(int16_t)));
+  writeU16(header, 16);
+  header.insert(header.end(), {'d', 'a', 't', 'a'});
+  writeU32(header, data_size_);
+
+  // The samples written so far are kept after the header
+  file_.seekp(0);
+  file_.write(header.data(), static_cast<std::streamsize>(header.size()));
+  file_.seekp(0, std::ios::end);
+}
@@ -20,8 +20,10 @@
 #include <thread>
 #include <string>
 #include <chrono>
+#include <ctime>
 #include <sstream>
 #include <fstream>
+#include <map>
 
 // DSR
 #include "dsr/api/dsr_api.h"
@@ -32,6 +34,7 @@
 #include "oatpp-websocket/WebSocket.hpp"
 
 // UTILS
+#include "../../include/async_logger.hpp"
 #include "../../include/json_messages.hpp"
 
 extern std::shared_ptr<oatpp::websocket::WebSocket> my_socket;
@@ -67,6 +70,9 @@ class DSR_interface: public QObject{
 	bool use_subtitles_;
 	std::string robot_name_;
 
+	// Logger. The calls below SPDLOG_ACTIVE_LEVEL are removed at compile time
+	std::shared_ptr<spdlog::logger> logger_;
+
 	DSR_interface();
     virtual ~DSR_interface();
     //######################//
@@ -74,6 +80,7 @@ class DSR_interface: public QObject{
 	//######################//
 	void initializeDSR();
 	bool configParamsParser(std::string file_path);
+	void initializeLogger();
 	void modify_node_slot(std::uint64_t, const std::string &type){};
 	void modify_node_attrs_slot(std::uint64_t id, const std::vector<std::string>& att_names);
 	void modify_edge_slot(std::uint64_t from, std::uint64_t to,  const std::string &type);
@@ -81,5 +88,8 @@ class DSR_interface: public QObject{
 	void del_edge_slot(std::uint64_t from, std::uint64_t to, const std::string &edge_tag);
 	void del_node_slot(std::uint64_t from){};
 	private:
+	// Log path and log_* parameters of the config file
+	std::string log_path_;
+	std::map<std::string, std::string> log_config_;
 };
 #endif // DSR_interface_hpp
\ No newline at end of file
@@ -45,7 +45,7 @@ DSR_interface::~DSR_interface() = default;
 void DSR_interface::initializeDSR(){
     // create graph
     G = std::make_shared<DSR::DSRGraph>(agent_name, agent_id, ""); // Init nodes
-    std::cout<< __FUNCTION__ << "Graph loaded" << std::endl;  
+    SPDLOG_LOGGER_INFO(logger_, "Graph loaded");
 
     //dsr update signals
     QObject::connect(G.get(), &DSR::DSRGraph::update_node_signal, this, &DSR_interface::modify_node_slot);
@@ -71,6 +71,8 @@ bool DSR_interface::configParamsParser(std::string file_path){
     std::string line;
     std::cout << "Configuration parameters:";
     while(std::getline(configFile, line)){
+        // Ignore comments and empty lines
+        if (line.empty() || line[0] == '#') {continue;}
         std::istringstream is_line(line);
         std::string key, value;
         if (std::getline(is_line, key, '=') && std::getline(is_line, value)){
@@ -80,6 +82,10 @@ bool DSR_interface::configParamsParser(std::string file_path){
                 agent_name = value;
             }else if(key == "robot_name"){
                 robot_name_ = value;
+            }else if(key == "log_path"){
+                log_path_ = value;
+            }else if(key.rfind("log_", 0) == 0){
+                log_config_[key] = value;
             }else{
                 std::cerr << "Error parsing not defined parameter: " << key << std::endl;
                 return false;
@@ -92,6 +98,16 @@ bool DSR_interface::configParamsParser(std::string file_path){
     return true;
 }
 
+void DSR_interface::initializeLogger(){
+    auto params = loggerParametersFromConfig(log_config_);
+    std::vector<spdlog::sink_ptr> sinks{createConsoleSink(params)};
+    if (!log_path_.empty()) {
+        std::string log_folder = log_path_ + std::to_string(std::time(nullptr)) + "/" + agent_name;
+        sinks.push_back(createFileSink(log_folder + "/debug.log", params));
+    }
+    logger_ = createAsyncLogger(agent_name, sinks, params);
+}
+
 void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<std::string>& att_names){
 	QMutexLocker locker(mutex);
 	auto node = G->get_node(id);
@@ -108,14 +124,14 @@ void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<s
                     if(conect){
                         my_socket->sendOneFrameText(mensaje);
                     }
-                    std::cout << "Battery level: " << level << "sent to client" << std::endl;
+                    SPDLOG_LOGGER_DEBUG(logger_, "Battery level: {} sent to client", level);
 				}
 				// Check if the attribute is battery_power_supply_status and send it to the webServer
 				if (search->first == "battery_power_supply_status"){
 					std::string battery_status = std::get<std::string>(search->second.value());
 					static  std::string prev_interface = "default";
-					std::cout << "Power supply status: " << battery_status << std::endl;
-					std::cout << "Previous interface: " << prev_interface << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "Power supply status: {}", battery_status);
+					SPDLOG_LOGGER_DEBUG(logger_, "Previous interface: {}", prev_interface);
 					std::optional<std::string> interface;
 					if (battery_status == "charging"){
 						interface = "charging";
@@ -123,7 +139,7 @@ void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<s
 					// Send the activation of the interface to the webServer
 					if (interface.has_value()){
 						prev_interface = interface.value();
-                        std::cout << "Interface: " << interface.value() << std::endl;
+                        SPDLOG_LOGGER_DEBUG(logger_, "Interface: {}", interface.value());
                         responseJsonInterface["interface"] = interface.value();
                         std::string mensaje = responseJsonInterface.dump();
                         if(conect){
@@ -141,7 +157,7 @@ void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<s
 				// Check if the attribute is menu_choices and send it to the client
 				if (search->first == "menu_choices1"){
 					std::string menu_choices1 = std::get<std::string>(search->second.value());
-                    std::cout << "Menu choices: " << menu_choices1 << std::endl;
+                    SPDLOG_LOGGER_DEBUG(logger_, "Menu choices: {}", menu_choices1);
                     MenuChoices parsed_menu_choices1(nlohmann::json::parse(menu_choices1));
 					
 					auto menu_choices2 = G->get_attrib_by_name<menu_choices2_att>(node.value());
@@ -157,8 +173,8 @@ void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<s
 					auto menu_choices7 = G->get_attrib_by_name<menu_choices7_att>(node.value());
 					MenuChoices parsed_menu_choices7(nlohmann::json::parse(menu_choices7.value()));
                     
-					std::cout << "Opciones primero: " << parsed_menu_choices1.primero1 << " || " 
-                                << parsed_menu_choices1.primero2 << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "Opciones primero: {} || {}",
+						parsed_menu_choices1.primero1, parsed_menu_choices1.primero2);
                     responseJsonMenuChoices["Lpri1"] = parsed_menu_choices1.primero1;
                     responseJsonMenuChoices["Lpri2"] = parsed_menu_choices1.primero2;
                     responseJsonMenuChoices["Lseg1"] = parsed_menu_choices1.segundo1;
@@ -189,11 +205,11 @@ void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<s
                     responseJsonMenuChoices["Dseg2"] = parsed_menu_choices7.segundo2;
                     responseJsonMenuChoices["pos"] = parsed_menu_choices1.postre1;
                     std::string mensaje = responseJsonMenuChoices.dump();
-					std::cout << "Pre conect" << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "Pre conect");
                     if(conect){
-						std::cout << "Pre Send Menu Choices to interface" << std::endl;
+						SPDLOG_LOGGER_DEBUG(logger_, "Pre Send Menu Choices to interface");
                         my_socket->sendOneFrameText(mensaje);
-						std::cout << "Send Menu Choices to interface" << std::endl;
+						SPDLOG_LOGGER_DEBUG(logger_, "Send Menu Choices to interface");
                     }
 				}
 			}
@@ -211,7 +227,7 @@ void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<s
                     if(conect){
                         my_socket->sendOneFrameText(mensaje);
                     }
-                    std::cout << "Question: " << question << "sent to client" << std::endl;
+                    SPDLOG_LOGGER_INFO(logger_, "Question: {} sent to client", question);
 				}
 				else if (search->first == "answer"){
 					std::string answer = std::get<std::string>(search->second.value());
@@ -220,7 +236,7 @@ void DSR_interface::modify_node_attrs_slot(std::uint64_t id, const std::vector<s
                     if(conect){
                         my_socket->sendOneFrameText(mensaje);
                     }
-                    std::cout << "Answer: " << answer << "sent to client" << std::endl;
+                    SPDLOG_LOGGER_INFO(logger_, "Answer: {} sent to client", answer);
 				}
 			}
 		}
@@ -231,13 +247,13 @@ void DSR_interface::modify_edge_slot(std::uint64_t from, std::uint64_t to,  cons
 	// Check if the robot is interacting with a person: robot ---(interacting)--> person
 	QMutexLocker locker(mutex);
 	if (type == "interacting"){
-		std::cout << "MODIFY EDGE interacting" << std::endl;
+		SPDLOG_LOGGER_DEBUG(logger_, "MODIFY EDGE interacting");
 		auto robot_node = G->get_node(from);
 		person_node = G->get_node(to);
 		if (robot_node.has_value() && robot_node.value().name() == robot_name_
 			&& person_node.has_value() && person_node.value().type() == "person"){
 			auto person_identifier = G->get_attrib_by_name<identifier_att>(person_node.value());
-			std::cout << "The person [" << person_identifier.value() << "] is interacting with the robot" << std::endl;
+			SPDLOG_LOGGER_INFO(logger_, "The person [{}] is interacting with the robot", person_identifier.value());
             responseJsonName["nombre"] = person_identifier.value();
             if(conect){ //Tracking use case
                 std::string mensaje = responseJsonName.dump();
@@ -256,40 +272,40 @@ void DSR_interface::modify_edge_slot(std::uint64_t from, std::uint64_t to,  cons
 			if(tracking_node.has_value()){
 				G->add_or_modify_attrib_local<identifier_att>(tracking_node.value(), person_identifier.value());
 				if(G->update_node(tracking_node.value())){
-					std::cout << "TRACKING NODE UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "TRACKING NODE UPDATED");
 				}else{
-					std::cout << "COULDN'T UPDATE TRACKING NODE" << std::endl;
+					SPDLOG_LOGGER_WARN(logger_, "COULDN'T UPDATE TRACKING NODE");
 				}
 			}
 		}
 	}
 	// Check if the robot wants to show the screen: robot ---(wants_to)--> show
 	else if (type == "wants_to"){
-		std::cout << "MODIFY EDGE wants_to" << std::endl;
+		SPDLOG_LOGGER_DEBUG(logger_, "MODIFY EDGE wants_to");
 		auto robot_node = G->get_node(from);
 		auto show_node = G->get_node(to);
 		if (robot_node.has_value() && robot_node.value().name() == robot_name_
 			&& show_node.has_value() && show_node.value().name() == "show"){
-			std::cout << "Wants to between robot and show" << std::endl;	
+			SPDLOG_LOGGER_DEBUG(logger_, "Wants to between robot and show");
 			if (G->delete_edge(robot_node.value().id(), show_node.value().id(), "wants_to")) {
 				auto edge = DSR::create_edge_with_priority<is_performing_edge_type>(G, robot_node.value().id(), show_node.value().id(), 0, robot_name_);
 				if (G->insert_or_assign_edge(edge)) {
-					std::cout << "Insertado edge: is_performing" << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "Insertado edge: is_performing");
 					// Get interface to show
 					auto interface = G->get_attrib_by_name<interface_att>(show_node.value());
 					if (interface.has_value()){
-						std::cout << "Selected Interface " << interface.value() << std::endl;
+						SPDLOG_LOGGER_DEBUG(logger_, "Selected Interface {}", interface.value());
 						responseJsonInterface["interface"] = interface.value();
 						std::string mensaje = responseJsonInterface.dump();
 						if(conect){
-							std::cout << "Sendig Interface " << interface.value() << std::endl;
+							SPDLOG_LOGGER_DEBUG(logger_, "Sendig Interface {}", interface.value());
 							if(button_socket){
 								button_socket->sendOneFrameText(mensaje);
-								std::cout << "Interface " << interface.value() << " has been sent to esp32" << std::endl;
+								SPDLOG_LOGGER_INFO(logger_, "Interface {} has been sent to esp32", interface.value());
 							}
 							if(my_socket){
 								my_socket->sendOneFrameText(mensaje);
-								std::cout << "Interface " << interface.value() << " has been sent to web" << std::endl;
+								SPDLOG_LOGGER_INFO(logger_, "Interface {} has been sent to web", interface.value());
 							}
 						}
 						if(interface.value() != "menu1" && interface.value() != "menu2" && interface.value() != "menu3" &&
@@ -300,10 +316,10 @@ void DSR_interface::modify_edge_slot(std::uint64_t from, std::uint64_t to,  cons
 							if (G->delete_edge(robot_node.value().id(), show_node.value().id(), "is_performing")) {
 								auto edge = DSR::create_edge_with_priority<finished_edge_type>(G, robot_node.value().id(), show_node.value().id(), 0, robot_name_);
 								if (G->insert_or_assign_edge(edge)) {
-									std::cout << "Finished action " <<  show_node.value().name() << endl;
+									SPDLOG_LOGGER_INFO(logger_, "Finished action {}", show_node.value().name());
 								}
 							}else {
-							std::cout << "ERROR: Trying to delete edge type is_performing" << std::endl;
+							SPDLOG_LOGGER_WARN(logger_, "ERROR: Trying to delete edge type is_performing");
 							}
 						}
 					}
@@ -313,60 +329,60 @@ void DSR_interface::modify_edge_slot(std::uint64_t from, std::uint64_t to,  cons
 	}
 	// Check if the robot cancel to show the screen: robot ---(cancel)--> show
 	else if (type == "cancel"){
-		std::cout << "MODIFY EDGE cancel" << std::endl;
+		SPDLOG_LOGGER_DEBUG(logger_, "MODIFY EDGE cancel");
 		auto robot_node = G->get_node(from);
 		auto show_node = G->get_node(to);
 		if (robot_node.has_value() && robot_node.value().name() == robot_name_
 			&& show_node.has_value() && show_node.value().name() == "show"){
-			std::cout << "Cancel between robot and show" << std::endl;
+			SPDLOG_LOGGER_DEBUG(logger_, "Cancel between robot and show");
 			if ( show_node.has_value() ) {	
 				// Delete node show
 				if (G->delete_node(show_node.value())) {
-					std::cout << "Delete node show" << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "Delete node show");
 				}
 				else{
-					std::cout << "Can not delete node show" << std::endl;
+					SPDLOG_LOGGER_WARN(logger_, "Can not delete node show");
 				}
 			}
 			else{
-				std::cout << "Can not delete node show because there is no node registered" << std::endl;
+				SPDLOG_LOGGER_WARN(logger_, "Can not delete node show because there is no node registered");
 			}			
 		}
 	}
 	// Check if the robot abort to show the screen: robot ---(abort)--> show
 	else if (type == "abort"){
-		std::cout << "MODIFY EDGE abort" << std::endl;
+		SPDLOG_LOGGER_DEBUG(logger_, "MODIFY EDGE abort");
 		auto robot_node = G->get_node(from);
 		auto show_node = G->get_node(to);
 		if (robot_node.has_value() && robot_node.value().name() == robot_name_
 			&& show_node.has_value() && show_node.value().name() == "show"){
-			std::cout << "Abort between robot and show" << std::endl;	
+			SPDLOG_LOGGER_DEBUG(logger_, "Abort between robot and show");
 			if ( show_node.has_value() ) {	
 				// Delete node show
 				if (G->delete_node(show_node.value())) {
-					std::cout << "Delete node show" << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "Delete node show");
 				}
 				else{
-					std::cout << "Can not delete node show" << std::endl;
+					SPDLOG_LOGGER_WARN(logger_, "Can not delete node show");
 				}
 			}
 			else{
-				std::cout << "Can not delete node show because there is no node registered" << std::endl;
+				SPDLOG_LOGGER_WARN(logger_, "Can not delete node show because there is no node registered");
 			}			
 		}
 	}
 	// Check if the robot is beginning to say something, to show subtitles (or not)
 	else if (type == "is_performing") {
-		std::cout << "MODIFY EDGE is_performing" << std::endl;
+		SPDLOG_LOGGER_DEBUG(logger_, "MODIFY EDGE is_performing");
 		auto robot_node = G->get_node(from);
 		auto say_node = G->get_node(to);
 		if (robot_node.has_value() && robot_node.value().name() == robot_name_
 			&& say_node.has_value() && say_node.value().name() == "say"){
-			std::cout << "is_performing between robot and say" << std::endl;
+			SPDLOG_LOGGER_DEBUG(logger_, "is_performing between robot and say");
 			if (use_subtitles_) {
-				std::cout << "using subtitles" << std::endl;
+				SPDLOG_LOGGER_DEBUG(logger_, "using subtitles");
 				if(auto text_sub = G->get_attrib_by_name<text_att>(say_node.value()); text_sub.has_value()){
-					std::cout << "Subtitles: " << text_sub.value() << std::endl;
+					SPDLOG_LOGGER_DEBUG(logger_, "Subtitles: {}", text_sub.value());
 					responseJsonSub["subtitulos"] = text_sub.value();
 					std::string mensaje = responseJsonSub.dump();
 					if(conect){
@@ -378,14 +394,14 @@ void DSR_interface::modify_edge_slot(std::uint64_t from, std::uint64_t to,  cons
 	}
 	// Check if the robot finished saying something, to erase subtitles (or not)
 	else if (type == "finished") {
-		std::cout << "MODIFY EDGE finished" << std::endl;
+		SPDLOG_LOGGER_DEBUG(logger_, "MODIFY EDGE finished");
 		auto robot_node = G->get_node(from);
 		auto say_node = G->get_node(to);
 		if (robot_node.has_value() && robot_node.value().name() == robot_name_
 			&& say_node.has_value() && say_node.value().name() == "say"){
-			std::cout << "finished between robot and say" << std::endl;
+			SPDLOG_LOGGER_DEBUG(logger_, "finished between robot and say");
 			if (use_subtitles_) {
-				std::cout << "using subtitles" << std::endl;
+				SPDLOG_LOGGER_DEBUG(logger_, "using subtitles");
 				std::string text_sub = "";
                 responseJsonSub["subtitulos"] = text_sub;
                 std::string mensaje = responseJsonSub.dump();
@@ -398,7 +414,7 @@ void DSR_interface::modify_edge_slot(std::uint64_t from, std::uint64_t to,  cons
 }
 
 void DSR_interface::del_edge_slot(std::uint64_t from, std::uint64_t to, const std::string &edge_tag){
-	std::cout << "Delete edge of type : " << edge_tag << std::endl;
+	SPDLOG_LOGGER_DEBUG(logger_, "Delete edge of type : {}", edge_tag);
 	// Check if the robot was interacting with a person: robot ---(interacting)--> person
 	if (edge_tag == "interacting"){	
 		use_subtitles_ = true; // returns to default behaviour (using subtitles) when interaction ends
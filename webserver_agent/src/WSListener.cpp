@@ -15,7 +15,6 @@
 
 #include "../include/WSListener.hpp"
 #include "nlohmann/json.hpp"
-#include <iostream>
 
 DSR_interface my_DSR;
 int cont_menu = 0;
@@ -25,31 +24,30 @@ MenuSelection menu_selection;
 // WSListener
 
 void WSListener::onPing(const WebSocket& socket, const oatpp::String& message) {
-	OATPP_LOGD(TAG, "onPing");
+	SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "{}: onPing", TAG);
 	socket.sendPong(message);
 }
 
 void WSListener::onPong(const WebSocket& socket, const oatpp::String& message) {
-	OATPP_LOGD(TAG, "onPong");
+	SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "{}: onPong", TAG);
 }
 
 void WSListener::onClose(const WebSocket& socket, v_uint16 code, const oatpp::String& message) {
-	OATPP_LOGD(TAG, "onClose code=%d", code);
+	SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "{}: onClose code={}", TAG, code);
 }
 
 void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 data, oatpp::v_io_size size) {
 	bool volume = false;
-	OATPP_LOGD(TAG, "Received Message");
 	// message transfer finished		
 	if(size == 0) { 
 		auto wholeMessage = m_messageBuffer.toString();
 		m_messageBuffer.setCurrentPosition(0);
 
 		std::string client_message = wholeMessage->c_str();
-		OATPP_LOGD(TAG, "onMessage message='%s'", client_message);
+		SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "{}: onMessage message='{}'", TAG, client_message);
 		nlohmann::json jmessage = nlohmann::json::parse(client_message);
 		std::string action = jmessage["action"].template get<std::string>();
-		std::cout << "RECEIVED ACTION: " << action << std::endl;
+		SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "RECEIVED ACTION: {}", action);
 
 		// ##### STARTING MENU ##### //
 		if(action == "MENU ON"){
@@ -66,17 +64,17 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			//nlohmann::json jmenu = nlohmann::json::parse(menu);
 			menu_selection.primero = menu;
 			// Acceder a los valores dentro del objeto JSON
-			std::cout << "Primer plato: " << menu_selection.primero << std::endl;
+			SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Primer plato: {}", menu_selection.primero);
 			responseJsonMenuSelected["number"] = "first";
 			std::string mensaje = responseJsonMenuSelected.dump();
 			// Create node menu_selection and edge is performing
 			auto robot_node = my_DSR.G->get_node(my_DSR.robot_name_);
 			DSR::Node newNode = DSR::Node::create<menu_selection_node_type>("menu_selection");
 			if (auto id = my_DSR.G->insert_node(newNode); id.has_value()){
-				std::cout << "Inserting node '" << newNode.name() << "' to the graph..." << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Inserting node '{}' to the graph...", newNode.name());
 				auto edge = DSR::Edge::create<is_performing_edge_type>(robot_node.value().id(),  newNode.id());
                 if (my_DSR.G->insert_or_assign_edge(edge)) {
-                    std::cout << "Inserted edge is_performing for menu_selection node" << std::endl;
+                    SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Inserted edge is_performing for menu_selection node");
                 }
 			}
 			// Sending response to  socket clients
@@ -92,7 +90,7 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			//nlohmann::json jmenu = nlohmann::json::parse(menu);
 			menu_selection.segundo = menu;
 			// Acceder a los valores dentro del objeto JSON
-			std::cout << "Segundo plato: " << menu_selection.segundo << std::endl;
+			SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Segundo plato: {}", menu_selection.segundo);
 			responseJsonMenuSelected["number"] = "second";
 			std::string mensaje = responseJsonMenuSelected.dump();
 			// Sending response to  socket clients
@@ -108,62 +106,62 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			//Mutex
 			QMutexLocker locker(mutex);
 			std::optional<std::string> person_identifier = my_DSR.G->get_attrib_by_name<identifier_att>(my_DSR.person_node.value());
-			std::cout << "Person Node = " << person_identifier.value() << " Menu = " << jmenu.dump(4) << std::endl; 
+			SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Person Node = {} Menu = {}", person_identifier.value(), jmenu.dump(4));
 			//Actualizar sus atributos con las opciones de menu
 			if(cont_menu == 0){
 				my_DSR.G->add_or_modify_attrib_local<menu1_att>(my_DSR.person_node.value(), jmenu.dump());
 				if(my_DSR.G->update_node(my_DSR.person_node.value())){
-					std::cout << "MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "MENU UPDATED");
 				}else{
-					std::cout << "FAIL MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "FAIL MENU UPDATED");
 				}
 			}
 			else if(cont_menu == 1){
 				my_DSR.G->add_or_modify_attrib_local<menu2_att>(my_DSR.person_node.value(), menu);
 				if(my_DSR.G->update_node(my_DSR.person_node.value())){
-					std::cout << "MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "MENU UPDATED");
 				}else{
-					std::cout << "FAIL MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "FAIL MENU UPDATED");
 				}
 			}
 			else if(cont_menu == 2){
 				my_DSR.G->add_or_modify_attrib_local<menu3_att>(my_DSR.person_node.value(), menu);
 				if(my_DSR.G->update_node(my_DSR.person_node.value())){
-					std::cout << "MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "MENU UPDATED");
 				}else{
-					std::cout << "FAIL MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "FAIL MENU UPDATED");
 				}
 			}
 			else if(cont_menu == 3){
 				my_DSR.G->add_or_modify_attrib_local<menu4_att>(my_DSR.person_node.value(), menu);
 				if(my_DSR.G->update_node(my_DSR.person_node.value())){
-					std::cout << "MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "MENU UPDATED");
 				}else{
-					std::cout << "FAIL MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "FAIL MENU UPDATED");
 				}
 			}
 			else if(cont_menu == 4){
 				my_DSR.G->add_or_modify_attrib_local<menu5_att>(my_DSR.person_node.value(), menu);
 				if(my_DSR.G->update_node(my_DSR.person_node.value())){
-					std::cout << "MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "MENU UPDATED");
 				}else{
-					std::cout << "FAIL MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "FAIL MENU UPDATED");
 				}
 			}
 			else if(cont_menu == 5){
 				my_DSR.G->add_or_modify_attrib_local<menu6_att>(my_DSR.person_node.value(), menu);
 				if(my_DSR.G->update_node(my_DSR.person_node.value())){
-					std::cout << "MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "MENU UPDATED");
 				}else{
-					std::cout << "FAIL MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "FAIL MENU UPDATED");
 				}
 			}
 			else if(cont_menu == 6){
 				my_DSR.G->add_or_modify_attrib_local<menu7_att>(my_DSR.person_node.value(), menu);
 				if(my_DSR.G->update_node(my_DSR.person_node.value())){
-					std::cout << "MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "MENU UPDATED");
 				}else{
-					std::cout << "FAIL MENU UPDATED" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "FAIL MENU UPDATED");
 				}
 			}
 			// Delete is_performing edge between robot and show node and create new edge fisnished
@@ -174,10 +172,10 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 				if (my_DSR.G->delete_edge(robot_node.value().id(), show_node.value().id(), "is_performing")) {
 					auto edge = DSR::Edge::create<finished_edge_type>(robot_node.value().id(),  show_node.value().id());
 					if (my_DSR.G->insert_or_assign_edge(edge)) {
-						std::cout << "Finished action " <<  show_node.value().name() << std::endl;
+						SPDLOG_LOGGER_INFO(my_DSR.logger_, "Finished action {}", show_node.value().name());
 					}
 				}else {
-				std::cout << "ERROR: Trying to delete edge type is_performing" << std::endl;
+				SPDLOG_LOGGER_WARN(my_DSR.logger_, "ERROR: Trying to delete edge type is_performing");
 				}
 			}
 			cont_menu++;
@@ -188,22 +186,22 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 		}else if(action == "INTERFACE"){
 			std::string client = jmessage["params"].template get<std::string>();
 			if(client == "button"){
-				std::cout << "Setting ESP-32 button socket" << std::endl;
+				SPDLOG_LOGGER_INFO(my_DSR.logger_, "Setting ESP-32 button socket");
 				button_socket = std::make_shared<oatpp::websocket::WebSocket>(socket.getConnection(), false);
 			}else if(client == "html"){
-				std::cout << "Setting HTML interface socket" << std::endl;
+				SPDLOG_LOGGER_INFO(my_DSR.logger_, "Setting HTML interface socket");
 				my_socket = std::make_shared<oatpp::websocket::WebSocket>(socket.getConnection(), false);
 			}
 			else{
-				std::cout << "Error, client type [" << client << "], must be [button] or [html]"  << std::endl;
+				SPDLOG_LOGGER_WARN(my_DSR.logger_, "Error, client type [{}], must be [button] or [html]", client);
 			}
 		}else if(action == "MENU OFF"){
 			responseJsonInterface["interface"] = "default";
 			std::string mensaje = responseJsonInterface.dump();
-			std::cout << "Sending Interface: " << mensaje << "\nConect value: " << conect << std::endl;
+			SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Sending Interface: {}, conect value: {}", mensaje, conect);
 			if(conect){
 				socket.sendOneFrameText(mensaje);
-				std::cout << "Interface has been sent..." << std::endl;
+				SPDLOG_LOGGER_INFO(my_DSR.logger_, "Interface has been sent...");
 			}
 		// ##### RECEIVED NEURON ##### //
 		}else if(action == "NEURON SELECTED"){
@@ -215,17 +213,17 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 		// ##### FINISHED NEURON ##### //
 		}else if(action == "NEURON OFF"){
 			accuracy = accuracy / tries;
-			std::cout << "accuracy:"  << accuracy << " // tries: " << tries << std::endl;
+			SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "accuracy:{} // tries: {}", accuracy, tries);
 			// Get the mutex and set person accuracy value
 			QMutexLocker locker(mutex);
 			std::optional<std::string> person_identifier = my_DSR.G->get_attrib_by_name<identifier_att>(my_DSR.person_node.value());
-			std::cout << "Person Node = " << person_identifier.value() << std::endl; 
+			SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Person Node = {}", person_identifier.value());
 			// Update person accuracy value
 			my_DSR.G->add_or_modify_attrib_local<accuracy_att>(my_DSR.person_node.value(), accuracy);
 			if(my_DSR.G->update_node(my_DSR.person_node.value())){
-				std::cout << "ACCURACY OK" << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "ACCURACY OK");
 			}else{
-				std::cout << "ACCURACY FAIL" << std::endl;
+				SPDLOG_LOGGER_WARN(my_DSR.logger_, "ACCURACY FAIL");
 			}
 			// Finished show
 			auto robot_node = my_DSR.G->get_node(my_DSR.robot_name_);
@@ -235,10 +233,10 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 				if (my_DSR.G->delete_edge(robot_node.value().id(), show_node.value().id(), "is_performing")) {
 					auto edge = DSR::Edge::create<finished_edge_type>(robot_node.value().id(),  show_node.value().id());
 					if (my_DSR.G->insert_or_assign_edge(edge)) {
-						std::cout << "Finished action " <<  show_node.value().name() << std::endl;
+						SPDLOG_LOGGER_INFO(my_DSR.logger_, "Finished action {}", show_node.value().name());
 					}
 				}else {
-				std::cout << "ERROR: Trying to delete edge type is_performing" << std::endl;
+				SPDLOG_LOGGER_WARN(my_DSR.logger_, "ERROR: Trying to delete edge type is_performing");
 				}
 			}
 			// Reset interface
@@ -246,7 +244,7 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			std::string mensaje = responseJsonInterface.dump();
 			if(conect){
 				socket.sendOneFrameText(mensaje);
-				std::cout << "Sent default interface ..." << std::endl;
+				SPDLOG_LOGGER_INFO(my_DSR.logger_, "Sent default interface ...");
 			}
 			// Reset control variables
 			tries = 0.0;
@@ -258,12 +256,12 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			DSR::Node newNode = DSR::Node::create<explanation_node_type>("explanation");
 			my_DSR.G->add_or_modify_attrib_local<source_att>(newNode, my_DSR.robot_name_);
 			if (auto id = my_DSR.G->insert_node(newNode); id.has_value()){
-				std::cout << "Inserting node '" << newNode.name() << "' to the graph..." << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Inserting node '{}' to the graph...", newNode.name());
 			}		
 			auto edge = DSR::Edge::create<wants_to_edge_type>(robot_node.value().id(), newNode.id());
 			my_DSR.G->add_or_modify_attrib_local<source_att>(edge, my_DSR.robot_name_);
 			if (my_DSR.G->insert_or_assign_edge(edge)) {
-				std::cout << "Wants_to edge" << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Wants_to edge");
 			}
 		// ##### BRING ME WATER ##### //
 		}else if(action == "BUTTON WATER"){
@@ -272,12 +270,12 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			DSR::Node newNode = DSR::Node::create<bring_water_node_type>("bring_water");
 			my_DSR.G->add_or_modify_attrib_local<source_att>(newNode, my_DSR.robot_name_);
 			if (auto id = my_DSR.G->insert_node(newNode); id.has_value()){
-				std::cout << "Inserting node '" << newNode.name() << "' to the graph..." << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Inserting node '{}' to the graph...", newNode.name());
 			}		
 			auto edge = DSR::Edge::create<wants_to_edge_type>(robot_node.value().id(), newNode.id());
 			my_DSR.G->add_or_modify_attrib_local<source_att>(edge, my_DSR.robot_name_);
 			if (my_DSR.G->insert_or_assign_edge(edge)) {
-				std::cout << "Wants_to edge" << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Wants_to edge");
 			}
 		// ##### FINISH BRING ME WATER ##### //
 		}else if(action == "BUTTON WATER OFF"){
@@ -291,7 +289,7 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 				// Update person necessity
 				my_DSR.G->add_or_modify_attrib_local<necessity_att>(my_DSR.person_node.value(), necessity);
 				my_DSR.G->update_node(my_DSR.person_node.value());
-				std::cout << "Updated person node with necessity att: " << necessity << std::endl;
+				SPDLOG_LOGGER_INFO(my_DSR.logger_, "Updated person node with necessity att: {}", necessity);
 			}
 			// Finish bring me water use case
 			auto show_node = my_DSR.G->get_node("show");
@@ -300,10 +298,10 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 					if (my_DSR.G->delete_edge(robot_node.value().id(), show_node.value().id(), "is_performing")) {
 						auto edge = DSR::Edge::create<finished_edge_type>(robot_node.value().id(),  show_node.value().id());
 						if (my_DSR.G->insert_or_assign_edge(edge)) {
-							std::cout << "Finished action " <<  show_node.value().name() << std::endl;
+							SPDLOG_LOGGER_INFO(my_DSR.logger_, "Finished action {}", show_node.value().name());
 						}
 					}else {
-					std::cout << "ERROR: Trying to delete edge type is_performing" << std::endl;
+					SPDLOG_LOGGER_WARN(my_DSR.logger_, "ERROR: Trying to delete edge type is_performing");
 					}
 			}
 		// ##### SET VOLUME ##### //	
@@ -317,12 +315,12 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			my_DSR.G->add_or_modify_attrib_local<source_att>(newNode, my_DSR.robot_name_);
 			my_DSR.G->add_or_modify_attrib_local<volume_att>(newNode, vol);
 			if (auto id = my_DSR.G->insert_node(newNode); id.has_value()){
-				std::cout << "Inserting node '" << newNode.name() << "' to the graph..." << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Inserting node '{}' to the graph...", newNode.name());
 			}		
 			auto edge = DSR::Edge::create<wants_to_edge_type>(robot_node.value().id(), newNode.id());
 			my_DSR.G->add_or_modify_attrib_local<source_att>(edge, my_DSR.robot_name_);
 			if (my_DSR.G->insert_or_assign_edge(edge)) {
-				std::cout << "Wants_to edge" << endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Wants_to edge");
 			}
 		// ##### TRACKING ON ##### //
 		}else if(action == "BUTTON TRACKING ON"){
@@ -330,12 +328,12 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			DSR::Node newNode = DSR::Node::create<track_node_type>("tracking");
 			my_DSR.G->add_or_modify_attrib_local<source_att>(newNode, my_DSR.robot_name_);
 			if (auto id = my_DSR.G->insert_node(newNode); id.has_value()){
-				std::cout << "Inserting node '" << newNode.name() << "' to the graph..." << std::endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Inserting node '{}' to the graph...", newNode.name());
 			}		
 			auto edge = DSR::Edge::create<wants_to_edge_type>(robot_node.value().id(), newNode.id());
 			my_DSR.G->add_or_modify_attrib_local<source_att>(edge, my_DSR.robot_name_);
 			if (my_DSR.G->insert_or_assign_edge(edge)) {
-				std::cout << "Wants_to edge" << endl;
+				SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Wants_to edge");
 			}
 		// ##### TRACKING OFF ##### //
 		}else if(action == "BUTTON TRACKING OFF"){
@@ -344,7 +342,7 @@ void WSListener::readMessage(const WebSocket& socket, v_uint8 opcode, p_char8 da
 			if(robot_node.has_value() && tracking_node.has_value()){
 				bool repl_edge = DSR::replace_edge<finished_edge_type>(my_DSR.G,robot_node.value().id(),tracking_node.value().id(),"is_performing", my_DSR.robot_name_);
 				if(repl_edge){
-					std::cout << "Edge replace correctly" << std::endl;
+					SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "Edge replace correctly");
 				}
 			}
 		}
@@ -360,7 +358,7 @@ std::atomic<v_int32> WSInstanceListener::SOCKETS(0);
 void WSInstanceListener::onAfterCreate(const oatpp::websocket::WebSocket& socket, const std::shared_ptr<const ParameterMap>& params) {
 	// Increse sockets counter and print conection is done
 	SOCKETS ++;
-	OATPP_LOGD(TAG, "New Incoming Connection. Connection count=%d", SOCKETS.load());
+	SPDLOG_LOGGER_INFO(my_DSR.logger_, "{}: New Incoming Connection. Connection count={}", TAG, SOCKETS.load());
 	// Genereate shared pointer from the socket for assync server->client comunication
 	socket.setListener(std::make_shared<WSListener>());
 	conect = SOCKETS;
@@ -376,11 +374,11 @@ void WSInstanceListener::onAfterCreate(const oatpp::websocket::WebSocket& socket
 	socket.sendOneFrameText(batt_message);
 	std::string mensajeSub = responseJsonSub.dump();
 	socket.sendOneFrameText( mensajeSub);
-	OATPP_LOGD(TAG, "Socket connection created and enviroment variables were initialized");
+	SPDLOG_LOGGER_DEBUG(my_DSR.logger_, "{}: Socket connection created and enviroment variables were initialized", TAG);
 }
 
 void WSInstanceListener::onBeforeDestroy(const oatpp::websocket::WebSocket& socket) {
 	SOCKETS --;
-	OATPP_LOGD(TAG, "Connection closed. Connection count=%d", SOCKETS.load());
+	SPDLOG_LOGGER_INFO(my_DSR.logger_, "{}: Connection closed. Connection count={}", TAG, SOCKETS.load());
 	conect = SOCKETS;
 }
\ No newline at end of file
@@ -97,7 +97,7 @@ namespace MyOatppFunctions {
             };
 
             /* Print info about server port */
-            OATPP_LOGI("MyApp", "Server running on port %s", connectionProvider->getProperty("port").getData());
+            SPDLOG_LOGGER_INFO(my_DSR.logger_, "Server running on port {}", connectionProvider->getProperty("port").std_str());
 
             server.run(condition);
 
@@ -191,6 +191,7 @@ int main(int argc, char* argv[]){
     if(!my_DSR.configParamsParser(argv[1])){
         return -1;
     }
+    my_DSR.initializeLogger();
     initializeJson();
     my_DSR.initializeDSR();
     oatpp::base::Environment::init();